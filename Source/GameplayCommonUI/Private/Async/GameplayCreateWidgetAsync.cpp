@@ -7,6 +7,7 @@
 #include "Engine/AssetManager.h"
 #include "Engine/GameInstance.h"
 #include "Misc/GameplayCommonUILibrary.h"
+#include "Subsystems/GameplayCommonUISubsystem.h"
 
 static const FName InputFilterReason_Template = FName(TEXT("CreatingWidgetAsync"));
 
@@ -42,14 +43,24 @@ void UGameplayCreateWidgetAsync::Activate()
 {
 	SuspendInputToken = bSuspendInputUntilComplete ? UGameplayCommonUILibrary::SuspendInputForPlayer(OwningPlayer.Get(), InputFilterReason_Template) : NAME_None;
 
+	// Loads go through the shared cache so bursts of nodes for the same class share one request.
+	if (UGameplayCommonUISubsystem* UIManager = GameInstance.IsValid() ? GameInstance->GetSubsystem<UGameplayCommonUISubsystem>() : nullptr)
+	{
+		UIManager->RequestSharedClassLoad(UserWidgetSoftClass.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ThisClass::OnWidgetLoaded));
+		return;
+	}
+
 	StreamingHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(UserWidgetSoftClass.ToSoftObjectPath(), 
 		FStreamableDelegate::CreateUObject(this, &ThisClass::OnWidgetLoaded), FStreamableManager::AsyncLoadHighPriority);
 
 	// Set up a cancel delegate so that we can resume input if this handler is canceled.
-	StreamingHandle->BindCancelDelegate(FStreamableDelegate::CreateWeakLambda(this, [this]()
+	if (StreamingHandle.IsValid())
 	{
-		UGameplayCommonUILibrary::ResumeInputForPlayer(OwningPlayer.Get(), SuspendInputToken);
-	}));
+		StreamingHandle->BindCancelDelegate(FStreamableDelegate::CreateWeakLambda(this, [this]()
+		{
+			UGameplayCommonUILibrary::ResumeInputForPlayer(OwningPlayer.Get(), SuspendInputToken);
+		}));
+	}
 }
 
 void UGameplayCreateWidgetAsync::Cancel()
@@ -59,12 +70,23 @@ void UGameplayCreateWidgetAsync::Cancel()
 		StreamingHandle->CancelHandle();
 		StreamingHandle.Reset();
 	}
+	else
+	{
+		// Shared loads are not ours to cancel, just stop waiting for them.
+		UGameplayCommonUILibrary::ResumeInputForPlayer(OwningPlayer.Get(), SuspendInputToken);
+		SuspendInputToken = NAME_None;
+	}
 	
 	Super::Cancel();
 }
 
 void UGameplayCreateWidgetAsync::OnWidgetLoaded()
 {
+	if (!IsActive())
+	{
+		return;
+	}
+	
 	if (bSuspendInputUntilComplete)
 	{
 		UGameplayCommonUILibrary::ResumeInputForPlayer(OwningPlayer.Get(), SuspendInputToken);
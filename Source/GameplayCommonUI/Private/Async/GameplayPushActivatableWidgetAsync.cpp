@@ -6,6 +6,7 @@
 #include "Engine/Engine.h"
 #include "Engine/LocalPlayer.h"
 #include "Widgets/GameplayPrimaryLayout.h"
+#include "Misc/GameplayCommonUILibrary.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogGameplayPushActivatableWidgetAsync, Log, All);
 
@@ -86,6 +87,19 @@ void UGameplayPushActivatableWidgetAsync::Activate()
 		return;
 	}
 	
+	// Bring the class in through the shared cache first, so bursts of nodes for the same class share one load.
+	if (!TargetWidgetClass.Get() && !bRequestedSharedLoad)
+	{
+		if (UGameplayCommonUISubsystem* UIManager = UGameplayCommonUISubsystem::Get(OwningPlayerPtr.Get()))
+		{
+			static const FName NAME_WaitingForSharedLoad("PushingWidgetToLayer");
+			bRequestedSharedLoad = true;
+			SharedLoadSuspendToken = bSuspendInputUntilComplete ? UGameplayCommonUILibrary::SuspendInputForPlayer(OwningPlayerPtr.Get(), NAME_WaitingForSharedLoad) : NAME_None;
+			UIManager->RequestSharedClassLoad(TargetWidgetClass.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ThisClass::OnSharedWidgetClassLoaded));
+			return;
+		}
+	}
+	
 	if (UGameplayPrimaryLayout* PrimaryLayout = UGameplayPrimaryLayout::GetPrimaryGameLayout(OwningPlayerPtr.Get()))
 	{
 		TWeakObjectPtr WeakThis = this;
@@ -93,7 +107,7 @@ void UGameplayPushActivatableWidgetAsync::Activate()
 		StreamingHandle = PrimaryLayout->PushWidgetToLayerStackAsync<UCommonActivatableWidget>(MyLayerTag, bSuspendInputUntilComplete, TargetWidgetClass,
 		[this, WeakThis](EGameplayWidgetLayerAsyncState State, UCommonActivatableWidget* Widget)
 		{
-			if (!WeakThis.IsValid() || !IsValid(Widget)) return;
+			if (!WeakThis.IsValid()) return;
 
 			switch (State)
 			{
@@ -102,12 +116,12 @@ void UGameplayPushActivatableWidgetAsync::Activate()
 				break;
 			case EGameplayWidgetLayerAsyncState::AfterPush:
 				AfterPush.Broadcast(Widget);
+				SetReadyToDestroy();
 				break;
 			case EGameplayWidgetLayerAsyncState::Canceled:
+				SetReadyToDestroy();
 				break;
 			}
-
-			SetReadyToDestroy();
 		});
 	}
 	else
@@ -140,8 +154,29 @@ void UGameplayPushActivatableWidgetAsync::OnPrimaryLayoutSet(UGameplayPrimaryLay
 	Activate();
 }
 
+void UGameplayPushActivatableWidgetAsync::OnSharedWidgetClassLoaded()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+	
+	if (!SharedLoadSuspendToken.IsNone())
+	{
+		UGameplayCommonUILibrary::ResumeInputForPlayer(OwningPlayerPtr.Get(), SharedLoadSuspendToken);
+		SharedLoadSuspendToken = NAME_None;
+	}
+	Activate();
+}
+
 void UGameplayPushActivatableWidgetAsync::Cancel()
 {
+	if (!SharedLoadSuspendToken.IsNone())
+	{
+		UGameplayCommonUILibrary::ResumeInputForPlayer(OwningPlayerPtr.Get(), SharedLoadSuspendToken);
+		SharedLoadSuspendToken = NAME_None;
+	}
+	
 	if (StreamingHandle.IsValid())
 	{
 		StreamingHandle->CancelHandle();
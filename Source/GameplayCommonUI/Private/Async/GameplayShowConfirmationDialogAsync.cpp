@@ -124,11 +124,11 @@ void UGameplayShowConfirmationDialogAsync::Activate()
 			const FGameplayConfirmationDialogResultSignature ResultCallback = FGameplayConfirmationDialogResultSignature::CreateUObject(this, &ThisClass::HandleConfirmationResult);
 			if (bIsErrorDialog)
 			{
-				UILocalPlayerSubsystem->ShowError(Descriptor, ResultCallback);
+				UILocalPlayerSubsystem->ShowErrorAsync(Descriptor, ResultCallback);
 			}
 			else
 			{
-				UILocalPlayerSubsystem->ShowConfirmation(Descriptor, ResultCallback);
+				UILocalPlayerSubsystem->ShowConfirmationAsync(Descriptor, ResultCallback);
 			}
 			return;
 		}
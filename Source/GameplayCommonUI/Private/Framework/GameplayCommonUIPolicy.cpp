@@ -4,7 +4,9 @@
 #include "Framework/Application/SlateApplication.h"
 #include "Widgets/GameplayPrimaryLayout.h"
 #include "Subsystems/GameplayCommonUISubsystem.h"
+#include "Subsystems/GameplayCommonLocalPlayerSubsystem.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 
@@ -45,14 +47,98 @@ UGameplayCommonUISubsystem* UGameplayCommonUIPolicy::GetOwningSubsystem() const
 
 UGameplayPrimaryLayout* UGameplayCommonUIPolicy::GetPrimaryLayoutFromLocalPlayer(const ULocalPlayer* LocalPlayer) const
 {
-	const FGameplayPrimaryLayoutViewport* LayoutInfo = PrimaryViewportLayouts.FindByKey(LocalPlayer);
+	const FGameplayPrimaryLayoutViewport* LayoutInfo = PrimaryViewportLayouts.Find(LocalPlayer);
 	return LayoutInfo ? LayoutInfo->PrimaryLayout : nullptr;
 }
 
 void UGameplayCommonUIPolicy::NotifyPawnChanged(ULocalPlayer* LocalPlayer, APawn* NewPawn)
 {
-	RemovePrimaryLayoutFromViewport(LocalPlayer, GetPrimaryLayoutFromLocalPlayer(LocalPlayer));
-	CreatePrimaryLayout(LocalPlayer);
+	// Layouts bind the current pawn when they are created, so there is nothing to do until one exists.
+	UGameplayPrimaryLayout* Layout = GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
+	if (!Layout || Layout->GetBoundPawn() == NewPawn)
+	{
+		return;
+	}
+	
+	if (PawnChangeMode == EGameplayLayoutPawnChangeMode::Recreate)
+	{
+		NotifyPlayerDestroyed(LocalPlayer);
+		CreatePrimaryLayout(LocalPlayer);
+	}
+	else
+	{
+		UE_LOG(LogGameplayUIPolicy, Verbose, TEXT("[%s] is rebinding player [%s]'s root layout [%s] to pawn [%s]"), *GetName(), *GetNameSafe(LocalPlayer), *GetNameSafe(Layout), *GetNameSafe(NewPawn));
+		
+		Layout->NotifyPawnChanged(NewPawn);
+		OnPrimaryLayoutPawnChanged(LocalPlayer, Layout, NewPawn);
+	}
+}
+
+void UGameplayCommonUIPolicy::PrewarmPrimaryLayout(ULocalPlayer* LocalPlayer)
+{
+	if (!LocalPlayer || GetPrimaryLayoutFromLocalPlayer(LocalPlayer) || PrewarmedLayouts.Contains(LocalPlayer))
+	{
+		return;
+	}
+	
+	const TSubclassOf<UGameplayPrimaryLayout> LayoutWidgetClass = GetPrimaryLayoutClass();
+	if (!LayoutWidgetClass || LayoutWidgetClass->HasAnyClassFlags(CLASS_Abstract))
+	{
+		return;
+	}
+	
+	// Widgets initialize while they are created and may query their player right away, which needs a valid player context.
+	APlayerController* PlayerController = LocalPlayer->GetPlayerController(GetWorld());
+	if (!PlayerController)
+	{
+		UE_LOG(LogGameplayUIPolicy, Verbose, TEXT("[%s] can't prewarm player [%s]'s root layout before it has a player controller"), *GetName(), *GetNameSafe(LocalPlayer));
+		return;
+	}
+	
+	UGameplayPrimaryLayout* Layout = CreateWidget<UGameplayPrimaryLayout>(PlayerController, LayoutWidgetClass);
+	if (!Layout)
+	{
+		return;
+	}
+	
+	UE_LOG(LogGameplayUIPolicy, Log, TEXT("[%s] is prewarming player [%s]'s root layout [%s]"), *GetName(), *GetNameSafe(LocalPlayer), *GetNameSafe(Layout));
+	
+	Layout->TakeWidget();
+	PrewarmedLayouts.Add(LocalPlayer, Layout);
+	
+	TArray<FSoftObjectPath> LayerWidgetPaths;
+	for (const TSoftClassPtr<UCommonActivatableWidget>& LayerWidgetClass : PrewarmedLayerWidgetClasses)
+	{
+		if (!LayerWidgetClass.IsNull())
+		{
+			LayerWidgetPaths.Add(LayerWidgetClass.ToSoftObjectPath());
+		}
+	}
+	
+	if (LayerWidgetPaths.Num() > 0)
+	{
+		const TObjectKey<ULocalPlayer> LocalPlayerKey(LocalPlayer);
+		const TWeakObjectPtr<UGameplayPrimaryLayout> WeakLayout(Layout);
+		TSharedPtr<FStreamableHandle> LoadHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(LayerWidgetPaths, FStreamableDelegate::CreateWeakLambda(this, 
+		[this, LocalPlayerKey, WeakLayout, LayerWidgetClasses = PrewarmedLayerWidgetClasses]()
+		{
+			if (UGameplayPrimaryLayout* PrewarmedLayout = WeakLayout.Get())
+			{
+				for (const TSoftClassPtr<UCommonActivatableWidget>& LayerWidgetClass : LayerWidgetClasses)
+				{
+					PrewarmedLayout->PrewarmLayerWidget(LayerWidgetClass.Get());
+				}
+			}
+			
+			// The prewarmed instances keep their classes loaded from here on.
+			PrewarmLayerWidgetsHandles.Remove(LocalPlayerKey);
+		}));
+		
+		if (LoadHandle.IsValid() && !LoadHandle->HasLoadCompleted())
+		{
+			PrewarmLayerWidgetsHandles.Add(LocalPlayerKey, MoveTemp(LoadHandle));
+		}
+	}
 }
 
 TSubclassOf<UGameplayPrimaryLayout> UGameplayCommonUIPolicy::GetPrimaryLayoutClass()
@@ -113,6 +199,11 @@ void UGameplayCommonUIPolicy::OnPrimaryLayoutReleased(ULocalPlayer* LocalPlayer,
 	// ...
 }
 
+void UGameplayCommonUIPolicy::OnPrimaryLayoutPawnChanged(ULocalPlayer* LocalPlayer, UGameplayPrimaryLayout* Layout, APawn* NewPawn)
+{
+	// ...
+}
+
 void UGameplayCommonUIPolicy::CreatePrimaryLayout(ULocalPlayer* LocalPlayer)
 {
 	if (APlayerController* PlayerController = LocalPlayer->GetPlayerController(GetWorld()))
@@ -120,10 +211,22 @@ void UGameplayCommonUIPolicy::CreatePrimaryLayout(ULocalPlayer* LocalPlayer)
 		const TSubclassOf<UGameplayPrimaryLayout> LayoutWidgetClass = GetPrimaryLayoutClass();
 		if (ensure(LayoutWidgetClass && !LayoutWidgetClass->HasAnyClassFlags(CLASS_Abstract)))
 		{
-			UGameplayPrimaryLayout* NewLayoutObject = CreateWidget<UGameplayPrimaryLayout>(PlayerController, LayoutWidgetClass);
-			PrimaryViewportLayouts.Emplace(LocalPlayer, NewLayoutObject, true);
+			// A prewarmed layout only needs to be attached, otherwise build one now.
+			TObjectPtr<UGameplayPrimaryLayout> NewLayoutObject = nullptr;
+			if (!PrewarmedLayouts.RemoveAndCopyValue(LocalPlayer, NewLayoutObject) || !NewLayoutObject || NewLayoutObject->GetClass() != LayoutWidgetClass 
+				|| NewLayoutObject->GetOwningPlayer() != PlayerController)
+			{
+				NewLayoutObject = CreateWidget<UGameplayPrimaryLayout>(PlayerController, LayoutWidgetClass);
+			}
+			
+			PrimaryViewportLayouts.Add(LocalPlayer, FGameplayPrimaryLayoutViewport(LocalPlayer, NewLayoutObject, true));
+			if (UGameplayCommonLocalPlayerSubsystem* UILocalPlayerSubsystem = LocalPlayer->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>())
+			{
+				UILocalPlayerSubsystem->SetPrimaryLayout(NewLayoutObject);
+			}
 
 			AddPrimaryLayoutToViewport(LocalPlayer, NewLayoutObject);
+			NewLayoutObject->NotifyPawnChanged(PlayerController->GetPawn());
 			
 			if (LocalPlayer->IsPrimaryPlayer())
 			{
@@ -135,11 +238,19 @@ void UGameplayCommonUIPolicy::CreatePrimaryLayout(ULocalPlayer* LocalPlayer)
 	}
 }
 
+void UGameplayCommonUIPolicy::NotifyPlayerCreated(ULocalPlayer* LocalPlayer)
+{
+	if (bPrewarmPrimaryLayoutOnPlayerCreated)
+	{
+		PrewarmPrimaryLayout(LocalPlayer);
+	}
+}
+
 void UGameplayCommonUIPolicy::NotifyPlayerAdded(ULocalPlayer* LocalPlayer)
 {
 	NotifyPlayerRemoved(LocalPlayer);
 	
-	if (FGameplayPrimaryLayoutViewport* LayoutInfo = PrimaryViewportLayouts.FindByKey(LocalPlayer))
+	if (FGameplayPrimaryLayoutViewport* LayoutInfo = PrimaryViewportLayouts.Find(LocalPlayer))
 	{
 		AddPrimaryLayoutToViewport(LocalPlayer, LayoutInfo->PrimaryLayout);
 		LayoutInfo->bAddedToViewport = true;
@@ -152,7 +263,7 @@ void UGameplayCommonUIPolicy::NotifyPlayerAdded(ULocalPlayer* LocalPlayer)
 
 void UGameplayCommonUIPolicy::NotifyPlayerRemoved(ULocalPlayer* LocalPlayer)
 {
-	if (FGameplayPrimaryLayoutViewport* LayoutInfo = PrimaryViewportLayouts.FindByKey(LocalPlayer))
+	if (FGameplayPrimaryLayoutViewport* LayoutInfo = PrimaryViewportLayouts.Find(LocalPlayer))
 	{
 		RemovePrimaryLayoutFromViewport(LocalPlayer, LayoutInfo->PrimaryLayout);
 		LayoutInfo->bAddedToViewport = false;
@@ -163,8 +274,9 @@ void UGameplayCommonUIPolicy::NotifyPlayerRemoved(ULocalPlayer* LocalPlayer)
 			// We're removing a secondary player's root while it's in control - transfer control back to the primary player's root
 			RootLayout->SetIsDormant(true);
 			
-			for (const FGameplayPrimaryLayoutViewport& RootLayoutInfo : PrimaryViewportLayouts)
+			for (const TPair<TObjectPtr<ULocalPlayer>, FGameplayPrimaryLayoutViewport>& LayoutPair : PrimaryViewportLayouts)
 			{
+				const FGameplayPrimaryLayoutViewport& RootLayoutInfo = LayoutPair.Value;
 				if (RootLayoutInfo.LocalPlayer && RootLayoutInfo.LocalPlayer->IsPrimaryPlayer())
 				{
 					if (UGameplayPrimaryLayout* PrimaryRootLayout = RootLayoutInfo.PrimaryLayout)
@@ -181,11 +293,22 @@ void UGameplayCommonUIPolicy::NotifyPlayerDestroyed(ULocalPlayer* LocalPlayer)
 {
 	NotifyPlayerRemoved(LocalPlayer);
 	
-	const int32 LayoutInfoIdx = PrimaryViewportLayouts.IndexOfByKey(LocalPlayer);
-	if (LayoutInfoIdx != INDEX_NONE)
+	PrewarmedLayouts.Remove(LocalPlayer);
+	
+	TSharedPtr<FStreamableHandle> PrewarmLoadHandle;
+	if (PrewarmLayerWidgetsHandles.RemoveAndCopyValue(LocalPlayer, PrewarmLoadHandle) && PrewarmLoadHandle.IsValid())
 	{
-		UGameplayPrimaryLayout* Layout = PrimaryViewportLayouts[LayoutInfoIdx].PrimaryLayout;
-		PrimaryViewportLayouts.RemoveAt(LayoutInfoIdx);
+		PrewarmLoadHandle->CancelHandle();
+	}
+	
+	FGameplayPrimaryLayoutViewport LayoutInfo;
+	if (PrimaryViewportLayouts.RemoveAndCopyValue(LocalPlayer, LayoutInfo))
+	{
+		UGameplayPrimaryLayout* Layout = LayoutInfo.PrimaryLayout;
+		if (UGameplayCommonLocalPlayerSubsystem* UILocalPlayerSubsystem = LocalPlayer->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>())
+		{
+			UILocalPlayerSubsystem->SetPrimaryLayout(nullptr);
+		}
 
 		RemovePrimaryLayoutFromViewport(LocalPlayer, Layout);
 
@@ -22,3 +22,22 @@ UGameplayCommonUISettings::UGameplayCommonUISettings(const FObjectInitializer& O
 		ErrorDialogClass = DefaultErrorDialogClass.Class;
 	}
 }
+
+TArray<FSoftObjectPath> UGameplayCommonUISettings::GetActivatableWidgetPaths(EGameplayWidgetResidency Residency) const
+{
+	TArray<FSoftObjectPath> Paths;
+	for (const TPair<FGameplayTag, EGameplayWidgetResidency>& Entry : ActivatableWidgetResidency)
+	{
+		if (Entry.Value != Residency)
+		{
+			continue;
+		}
+		
+		const TSoftClassPtr<UCommonActivatableWidget> WidgetClass = RegisteredActivatableWidgets.FindRef(Entry.Key);
+		if (!WidgetClass.IsNull())
+		{
+			Paths.AddUnique(WidgetClass.ToSoftObjectPath());
+		}
+	}
+	return Paths;
+}
@@ -0,0 +1,14 @@
+﻿// Copyright Spike Plugins 2026. All Rights Reserved.
+
+#include "Misc/GameplayCommonStats.h"
+
+DEFINE_STAT(STAT_GameplayUI_NotifyPointsOfExtension);
+DEFINE_STAT(STAT_GameplayUI_NotifyPointOfExtensions);
+DEFINE_STAT(STAT_GameplayUI_FlushExtensionBatch);
+DEFINE_STAT(STAT_GameplayUI_CreateExtensionWidget);
+DEFINE_STAT(STAT_GameplayUI_NumExtensionPoints);
+DEFINE_STAT(STAT_GameplayUI_NumExtensions);
+DEFINE_STAT(STAT_GameplayUI_ExtensionNotifications);
+DEFINE_STAT(STAT_GameplayUI_ExtensionWidgetsCreated);
+
+CSV_DEFINE_CATEGORY_MODULE(GAMEPLAYCOMMONUI_API, GameplayCommonUI, /*bIsEnabledByDefault=*/false);
@@ -8,10 +8,56 @@
 #include "Engine/LocalPlayer.h"
 #include "Engine/GameInstance.h"
 #include "Subsystems/GameplayCommonUISubsystem.h"
+#include "Subsystems/GameplayCommonLocalPlayerSubsystem.h"
 #include "Widgets/GameplayPrimaryLayout.h"
 #include "CommonActivatableWidget.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/AssetManager.h"
 
-int32 UGameplayCommonUILibrary::InputSuspensions = 0;
+DEFINE_LOG_CATEGORY_STATIC(LogGameplayUILibrary, Log, All);
+
+bool FGameplayWidgetPrefetchHandle::IsValid() const
+{
+	return StreamableHandle.IsValid() && StreamableHandle->IsActive();
+}
+
+bool FGameplayWidgetPrefetchHandle::HasLoadCompleted() const
+{
+	return StreamableHandle.IsValid() && StreamableHandle->HasLoadCompleted();
+}
+
+float FGameplayWidgetPrefetchHandle::GetProgress() const
+{
+	return StreamableHandle.IsValid() ? StreamableHandle->GetProgress() : 0.0f;
+}
+
+bool FGameplayWidgetPrefetchHandle::WaitUntilComplete(float Timeout) const
+{
+	if (!StreamableHandle.IsValid())
+	{
+		return false;
+	}
+	
+	return StreamableHandle->WaitUntilComplete(Timeout) == EAsyncPackageState::Complete;
+}
+
+void FGameplayWidgetPrefetchHandle::Cancel()
+{
+	if (StreamableHandle.IsValid())
+	{
+		StreamableHandle->CancelHandle();
+		StreamableHandle.Reset();
+	}
+}
+
+void FGameplayWidgetPrefetchHandle::Release()
+{
+	if (StreamableHandle.IsValid())
+	{
+		StreamableHandle->ReleaseHandle();
+		StreamableHandle.Reset();
+	}
+}
 
 ECommonInputType UGameplayCommonUILibrary::GetOwningPlayerInputType(const UUserWidget* WidgetContextObject)
 {
@@ -50,6 +96,14 @@ bool UGameplayCommonUILibrary::IsOwningPlayerUsingGamepad(const UUserWidget* Wid
 	return false;
 }
 
+UGameplayPrimaryLayout* UGameplayCommonUILibrary::ResolvePrimaryLayout(const ULocalPlayer* LocalPlayer)
+{
+	if (!IsValid(LocalPlayer)) return nullptr;
+
+	const UGameplayCommonLocalPlayerSubsystem* UILocalPlayerSubsystem = LocalPlayer->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>();
+	return UILocalPlayerSubsystem ? UILocalPlayerSubsystem->GetPrimaryLayout() : nullptr;
+}
+
 void UGameplayCommonUILibrary::PopSingleWidget(UCommonActivatableWidget* ActivatableWidget)
 {
 	if (!ActivatableWidget)
@@ -61,14 +115,8 @@ void UGameplayCommonUILibrary::PopSingleWidget(UCommonActivatableWidget* Activat
 	const ULocalPlayer* LocalPlayer = ActivatableWidget->GetOwningLocalPlayer();
 	if (!IsValid(LocalPlayer)) return;
 
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return;
+	UGameplayPrimaryLayout* RootLayout = ResolvePrimaryLayout(LocalPlayer);
+	if (!RootLayout) return;
 
 	RootLayout->FindAndRemoveWidgetFromLayer(ActivatableWidget);
 }
@@ -80,14 +128,8 @@ void UGameplayCommonUILibrary::PopWidgetsFromLayer(const APlayerController* Owni
 	const ULocalPlayer* LocalPlayer = OwningPlayer->GetLocalPlayer();
 	if (!IsValid(LocalPlayer)) return;
 
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return;
+	UGameplayPrimaryLayout* RootLayout = ResolvePrimaryLayout(LocalPlayer);
+	if (!RootLayout) return;
 
 	RootLayout->FindAndRemoveWidgetsFromLayer(LayerTag);
 }
@@ -99,14 +141,8 @@ void UGameplayCommonUILibrary::PopWidgetsFromLayout(APlayerController* OwningPla
 	const ULocalPlayer* LocalPlayer = OwningPlayer->GetLocalPlayer();
 	if (!IsValid(LocalPlayer)) return;
 
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return;
+	UGameplayPrimaryLayout* RootLayout = ResolvePrimaryLayout(LocalPlayer);
+	if (!RootLayout) return;
 
 	RootLayout->ClearAllLayerStacks();
 }
@@ -121,39 +157,90 @@ UCommonActivatableWidget* UGameplayCommonUILibrary::PushActivatableWidgetForClas
 	const ULocalPlayer* LocalPlayer = OwningPlayer->GetLocalPlayer();
 	if (!IsValid(LocalPlayer)) return nullptr;
 
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return nullptr;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return nullptr;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return nullptr;
+	UGameplayPrimaryLayout* RootLayout = ResolvePrimaryLayout(LocalPlayer);
+	if (!RootLayout) return nullptr;
 
 	return RootLayout->PushWidgetToLayerStack(LayerTag, WidgetClass);
 }
 
-void UGameplayCommonUILibrary::PushStreamedActivatableWidgetForClass(const APlayerController* OwningPlayer, FGameplayTag LayerTag, TSoftClassPtr<UCommonActivatableWidget> WidgetClass)
+TSharedPtr<FStreamableHandle> UGameplayCommonUILibrary::PushStreamedActivatableWidgetForClass(const APlayerController* OwningPlayer, FGameplayTag LayerTag, TSoftClassPtr<UCommonActivatableWidget> WidgetClass,
+	TFunction<void(EGameplayWidgetLayerAsyncState, UCommonActivatableWidget*)> StateFunc)
 {
+	if (!StateFunc)
+	{
+		StateFunc = [](EGameplayWidgetLayerAsyncState, UCommonActivatableWidget*) {};
+	}
+	
 	if (!ensure(OwningPlayer) || !ensure(!WidgetClass.IsNull()))
 	{
-		return;
+		StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+		return nullptr;
 	}
 
-	const ULocalPlayer* LocalPlayer = OwningPlayer->GetLocalPlayer();
-	if (!IsValid(LocalPlayer)) return;
-
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return;
+	UGameplayPrimaryLayout* RootLayout = ResolvePrimaryLayout(OwningPlayer->GetLocalPlayer());
+	if (!RootLayout)
+	{
+		// The policy is still streaming in. Start loading the class right away and only defer the push until the policy and 
+		// the player's layout exist, the returned handle cancels the queued push.
+		UGameplayCommonUISubsystem* UIManager = UGameplayCommonUISubsystem::Get(OwningPlayer);
+		if (UIManager && UIManager->IsLoadingUIPolicy())
+		{
+			FStreamableManager& StreamableManager = UAssetManager::Get().GetStreamableManager();
+			TSharedPtr<FStreamableHandle> QueuedLoadHandle = StreamableManager.RequestAsyncLoad(WidgetClass.ToSoftObjectPath());
+			if (!QueuedLoadHandle.IsValid())
+			{
+				StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+				return nullptr;
+			}
+			
+			// Cancellation can come from the caller, before or after the class finished loading, or from the subsystem being torn 
+			// down. Report it exactly once whichever way it arrives.
+			TSharedRef<bool> bCancelReported = MakeShared<bool>(false);
+			auto ReportCanceled = [StateFunc, bCancelReported]()
+			{
+				if (!*bCancelReported)
+				{
+					*bCancelReported = true;
+					StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+				}
+			};
+			QueuedLoadHandle->BindCancelDelegate(FStreamableDelegate::CreateLambda(ReportCanceled));
+			
+			TWeakObjectPtr<const APlayerController> WeakOwningPlayer = OwningPlayer;
+			UIManager->CallOrQueueUntilPolicyReady([WeakOwningPlayer, LayerTag, WidgetClass, StateFunc, QueuedLoadHandle, ReportCanceled]() mutable
+			{
+				if (QueuedLoadHandle->WasCanceled())
+				{
+					ReportCanceled();
+					return;
+				}
+				
+				if (const APlayerController* QueuedOwningPlayer = WeakOwningPlayer.Get())
+				{
+					PushStreamedActivatableWidgetForClass(QueuedOwningPlayer, LayerTag, WidgetClass, MoveTemp(StateFunc));
+				}
+				else
+				{
+					ReportCanceled();
+				}
+				
+				// The push holds its own request from here on, cancelling the returned handle no longer affects it.
+				QueuedLoadHandle->ReleaseHandle();
+			},
+			[QueuedLoadHandle, ReportCanceled]()
+			{
+				QueuedLoadHandle->CancelHandle();
+				ReportCanceled();
+			});
+			return QueuedLoadHandle;
+		}
+		
+		StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+		return nullptr;
+	}
 
 	constexpr bool bSuspendInputUntilComplete = true;
-	RootLayout->PushWidgetToLayerStackAsync(LayerTag, bSuspendInputUntilComplete, WidgetClass);
+	return RootLayout->PushWidgetToLayerStackAsync<UCommonActivatableWidget>(LayerTag, bSuspendInputUntilComplete, WidgetClass, MoveTemp(StateFunc));
 }
 
 UCommonActivatableWidget* UGameplayCommonUILibrary::PushActivatableWidgetForTag(const APlayerController* OwningPlayer, FGameplayTag LayerTag, FGameplayTag WidgetTag)
@@ -166,14 +253,8 @@ UCommonActivatableWidget* UGameplayCommonUILibrary::PushActivatableWidgetForTag(
 	const ULocalPlayer* LocalPlayer = OwningPlayer->GetLocalPlayer();
 	if (!IsValid(LocalPlayer)) return nullptr;
 
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return nullptr;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return nullptr;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return nullptr;
+	UGameplayPrimaryLayout* RootLayout = ResolvePrimaryLayout(LocalPlayer);
+	if (!RootLayout) return nullptr;
 
 	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
 	const TSoftClassPtr<UCommonActivatableWidget> FoundWidget = Settings->RegisteredActivatableWidgets.FindRef(WidgetTag);
@@ -181,30 +262,32 @@ UCommonActivatableWidget* UGameplayCommonUILibrary::PushActivatableWidgetForTag(
 	return RootLayout->PushWidgetToLayerStack(LayerTag, FoundWidget.LoadSynchronous());
 }
 
-void UGameplayCommonUILibrary::PushStreamedActivatableWidgetForTag(const APlayerController* OwningPlayer, FGameplayTag LayerTag, FGameplayTag WidgetTag)
+TSharedPtr<FStreamableHandle> UGameplayCommonUILibrary::PushStreamedActivatableWidgetForTag(const APlayerController* OwningPlayer, FGameplayTag LayerTag, FGameplayTag WidgetTag,
+	TFunction<void(EGameplayWidgetLayerAsyncState, UCommonActivatableWidget*)> StateFunc)
 {
 	if (!ensure(OwningPlayer) || !ensure(WidgetTag.IsValid()))
 	{
-		return;
+		if (StateFunc)
+		{
+			StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+		}
+		return nullptr;
 	}
 
-	const ULocalPlayer* LocalPlayer = OwningPlayer->GetLocalPlayer();
-	if (!IsValid(LocalPlayer)) return;
-
-	const UGameplayCommonUISubsystem* UIManager = LocalPlayer->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager) return;
-
-	const UGameplayCommonUIPolicy* UIPolicy = UIManager->GetUIPolicy();
-	if (!IsValid(UIPolicy)) return;
-
-	UGameplayPrimaryLayout* RootLayout = UIPolicy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!IsValid(RootLayout)) return;
-
+	// Only resolve the soft path here, the class itself is streamed in by the layout.
 	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
 	const TSoftClassPtr<UCommonActivatableWidget> FoundWidget = Settings->RegisteredActivatableWidgets.FindRef(WidgetTag);
+	if (FoundWidget.IsNull())
+	{
+		UE_LOG(LogGameplayUILibrary, Warning, TEXT("No activatable widget is registered for tag [%s]"), *WidgetTag.ToString());
+		if (StateFunc)
+		{
+			StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+		}
+		return nullptr;
+	}
 
-	constexpr bool bSuspendInputUntilComplete = true;
-	RootLayout->PushWidgetToLayerStackAsync(LayerTag, bSuspendInputUntilComplete, FoundWidget.LoadSynchronous());
+	return PushStreamedActivatableWidgetForClass(OwningPlayer, LayerTag, FoundWidget, MoveTemp(StateFunc));
 }
 
 ULocalPlayer* UGameplayCommonUILibrary::GetLocalPlayerFromController(const APlayerController* PlayerController)
@@ -224,17 +307,9 @@ FName UGameplayCommonUILibrary::SuspendInputForPlayer(APlayerController* PlayerC
 
 FName UGameplayCommonUILibrary::SuspendInputForPlayer(const ULocalPlayer* LocalPlayer, FName SuspendReason)
 {
-	if (UCommonInputSubsystem* CommonInputSubsystem = UCommonInputSubsystem::Get(LocalPlayer))
+	if (UGameplayCommonLocalPlayerSubsystem* LocalPlayerSubsystem = LocalPlayer ? LocalPlayer->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>() : nullptr)
 	{
-		InputSuspensions++;
-		FName SuspendToken = SuspendReason;
-		SuspendToken.SetNumber(InputSuspensions);
-
-		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::MouseAndKeyboard, SuspendToken, true);
-		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::Gamepad, SuspendToken, true);
-		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::Touch, SuspendToken, true);
-
-		return SuspendToken;
+		return LocalPlayerSubsystem->SuspendInput(SuspendReason);
 	}
 
 	return NAME_None;
@@ -252,11 +327,9 @@ void UGameplayCommonUILibrary::ResumeInputForPlayer(const ULocalPlayer* LocalPla
 		return;
 	}
 
-	if (UCommonInputSubsystem* CommonInputSubsystem = UCommonInputSubsystem::Get(LocalPlayer))
+	if (UGameplayCommonLocalPlayerSubsystem* LocalPlayerSubsystem = LocalPlayer ? LocalPlayer->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>() : nullptr)
 	{
-		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::MouseAndKeyboard, SuspendReason, false);
-		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::Gamepad, SuspendReason, false);
-		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::Touch, SuspendReason, false);
+		LocalPlayerSubsystem->ResumeInput(SuspendReason);
 	}
 }
 
@@ -278,3 +351,69 @@ void UGameplayCommonUILibrary::OnPrimaryLayoutReady(const APlayerController* Own
 	}
 }
 
+FGameplayWidgetPrefetchHandle UGameplayCommonUILibrary::PrefetchWidgetClassesForTags(const FGameplayTagContainer& WidgetTags)
+{
+	TArray<FSoftObjectPath> ClassPaths;
+	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
+	for (const TPair<FGameplayTag, TSoftClassPtr<UCommonActivatableWidget>>& Entry : Settings->RegisteredActivatableWidgets)
+	{
+		if (!Entry.Value.IsNull() && Entry.Key.MatchesAny(WidgetTags))
+		{
+			ClassPaths.AddUnique(Entry.Value.ToSoftObjectPath());
+		}
+	}
+	
+	if (ClassPaths.IsEmpty())
+	{
+		UE_LOG(LogGameplayUILibrary, Warning, TEXT("No activatable widget is registered for tags [%s], nothing to prefetch"), *WidgetTags.ToStringSimple());
+	}
+	return PrefetchWidgetClassPaths(MoveTemp(ClassPaths));
+}
+
+FGameplayWidgetPrefetchHandle UGameplayCommonUILibrary::PrefetchWidgetClasses(const TArray<TSoftClassPtr<UUserWidget>>& WidgetClasses)
+{
+	TArray<FSoftObjectPath> ClassPaths;
+	ClassPaths.Reserve(WidgetClasses.Num());
+	for (const TSoftClassPtr<UUserWidget>& WidgetClass : WidgetClasses)
+	{
+		if (!WidgetClass.IsNull())
+		{
+			ClassPaths.AddUnique(WidgetClass.ToSoftObjectPath());
+		}
+	}
+	return PrefetchWidgetClassPaths(MoveTemp(ClassPaths));
+}
+
+FGameplayWidgetPrefetchHandle UGameplayCommonUILibrary::PrefetchWidgetClassPaths(TArray<FSoftObjectPath> ClassPaths, FStreamableDelegate OnComplete)
+{
+	FGameplayWidgetPrefetchHandle PrefetchHandle;
+	if (ClassPaths.IsEmpty() || !UAssetManager::IsInitialized())
+	{
+		OnComplete.ExecuteIfBound();
+		return PrefetchHandle;
+	}
+	
+	// One request for the whole batch, so the loader can schedule the packages together instead of screen by screen.
+	PrefetchHandle.StreamableHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(MoveTemp(ClassPaths), MoveTemp(OnComplete), FStreamableManager::DefaultAsyncLoadPriority);
+	return PrefetchHandle;
+}
+
+bool UGameplayCommonUILibrary::IsWidgetPrefetchComplete(const FGameplayWidgetPrefetchHandle& PrefetchHandle)
+{
+	return PrefetchHandle.HasLoadCompleted();
+}
+
+float UGameplayCommonUILibrary::GetWidgetPrefetchProgress(const FGameplayWidgetPrefetchHandle& PrefetchHandle)
+{
+	return PrefetchHandle.GetProgress();
+}
+
+void UGameplayCommonUILibrary::CancelWidgetPrefetch(FGameplayWidgetPrefetchHandle& PrefetchHandle)
+{
+	PrefetchHandle.Cancel();
+}
+
+void UGameplayCommonUILibrary::ReleaseWidgetPrefetch(FGameplayWidgetPrefetchHandle& PrefetchHandle)
+{
+	PrefetchHandle.Release();
+}
@@ -1,7 +1,15 @@
 ﻿// Copyright Spike Plugins 2026. All Rights Reserved.
 
 #include "Subsystems/GameplayCommonExtensionSubsystem.h"
+#include "Algo/StableSort.h"
 #include "Blueprint/UserWidget.h"
+#include "CanvasItem.h"
+#include "DisplayDebugHelpers.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "GameFramework/HUD.h"
+#include "GameplayTagsManager.h"
+#include "Misc/GameplayCommonStats.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogGameplayUIExtensionSubsystem, Log, All);
 
@@ -34,19 +42,34 @@ bool FGameplayUIExtensionPoint::DoesExtensionPassContract(const FGameplayUIExten
 		{
 			// The data can either be the literal class of the data type, or an instance of the class type.
 			const UClass* DataClass = DataPtr->IsA(UClass::StaticClass()) ? Cast<UClass>(DataPtr) : DataPtr->GetClass();
-			for (const UClass* AllowedDataClass : AllowedDataClasses)
-			{
-				if (DataClass->IsChildOf(AllowedDataClass) || DataClass->ImplementsInterface(AllowedDataClass))
-				{
-					return true;
-				}
-			}
+			return DoesDataClassPassContract(DataClass);
 		}
 	}
 
 	return false;
 }
 
+bool FGameplayUIExtensionPoint::DoesDataClassPassContract(const UClass* DataClass) const
+{
+	if (const bool* bCachedResult = DataClassContractCache.Find(DataClass))
+	{
+		return *bCachedResult;
+	}
+	
+	bool bPassesContract = false;
+	for (const UClass* AllowedDataClass : AllowedDataClasses)
+	{
+		if (DataClass->IsChildOf(AllowedDataClass) || DataClass->ImplementsInterface(AllowedDataClass))
+		{
+			bPassesContract = true;
+			break;
+		}
+	}
+	
+	DataClassContractCache.Add(DataClass, bPassesContract);
+	return bPassesContract;
+}
+
 void FGameplayUIExtensionPointHandle::Unregister()
 {
 	if (UGameplayCommonExtensionSubsystem* ExtensionSourcePtr = ExtensionSource.Get())
@@ -59,6 +82,22 @@ void FGameplayUIExtensionPointHandle::Unregister()
 // UGameplayUIExtensionSubsystem
 //=========================================================
 
+/** Removes an entry from its per-tag list in constant time, fixing up the index of the entry swapped into its slot */
+template<typename EntryType>
+static void RemoveFromTagList(TArray<FGameplayUIExtensionSlotId>& List, TGameplayUIExtensionSlab<EntryType>& Store, EntryType& Entry)
+{
+	const int32 ListIndex = Entry.ListIndex;
+	check(List.IsValidIndex(ListIndex) && Store.Find(List[ListIndex]) == &Entry);
+
+	List.RemoveAtSwap(ListIndex, EAllowShrinking::No);
+	if (List.IsValidIndex(ListIndex))
+	{
+		Store.Find(List[ListIndex])->ListIndex = ListIndex;
+	}
+
+	Entry.ListIndex = INDEX_NONE;
+}
+
 UGameplayCommonExtensionSubsystem::UGameplayCommonExtensionSubsystem()
 {
 }
@@ -66,10 +105,40 @@ UGameplayCommonExtensionSubsystem::UGameplayCommonExtensionSubsystem()
 void UGameplayCommonExtensionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+	
+	if (!IsTemplate())
+	{
+		AHUD::OnShowDebugInfo.AddUObject(this, &ThisClass::OnShowDebugInfo);
+	}
 }
 
 void UGameplayCommonExtensionSubsystem::Deinitialize()
 {
+	AHUD::OnShowDebugInfo.RemoveAll(this);
+	
+	ExtensionPointIndex.Reset();
+	
+	ExtensionBatchDepth = 0;
+	PendingNotifications.Reset();
+	PendingAddedIndices.Reset();
+	
+	PendingFreeExtensions.Reset();
+	PendingFreeExtensionPoints.Reset();
+	
+	// Drop the remaining entries so late unregistrations through outstanding handles don't resolve or count twice.
+	for (const TPair<FGameplayTag, FExtensionPointList>& ExtensionPointPair : ExtensionPointMap)
+	{
+		DEC_DWORD_STAT_BY(STAT_GameplayUI_NumExtensionPoints, ExtensionPointPair.Value.Num());
+	}
+	for (const TPair<FGameplayTag, FExtensionList>& ExtensionPair : ExtensionMap)
+	{
+		DEC_DWORD_STAT_BY(STAT_GameplayUI_NumExtensions, ExtensionPair.Value.Num());
+	}
+	ExtensionPointMap.Reset();
+	ExtensionMap.Reset();
+	ExtensionPoints.Empty();
+	Extensions.Empty();
+	
 	Super::Deinitialize();
 }
 
@@ -79,21 +148,15 @@ void UGameplayCommonExtensionSubsystem::AddReferencedObjects(UObject* InThis, FR
 
 	if (UGameplayCommonExtensionSubsystem* ExtensionSubsystem = Cast<UGameplayCommonExtensionSubsystem>(InThis))
 	{
-		for (auto MapIt = ExtensionSubsystem->ExtensionPointMap.CreateIterator(); MapIt; ++MapIt)
+		ExtensionSubsystem->ExtensionPoints.ForEach([&Collector](FGameplayUIExtensionPoint& ExtensionPoint)
 		{
-			for (const TSharedPtr<FGameplayUIExtensionPoint>& ValueElement : MapIt.Value())
-			{
-				Collector.AddReferencedObjects(ValueElement->AllowedDataClasses);
-			}
-		}
+			Collector.AddReferencedObjects(ExtensionPoint.AllowedDataClasses);
+		});
 
-		for (auto MapIt = ExtensionSubsystem->ExtensionMap.CreateIterator(); MapIt; ++MapIt)
+		ExtensionSubsystem->Extensions.ForEach([&Collector](FGameplayUIExtension& Extension)
 		{
-			for (const TSharedPtr<FGameplayUIExtension>& ValueElement : MapIt.Value())
-			{
-				Collector.AddReferencedObject(ValueElement->Data);
-			}
-		}
+			Collector.AddReferencedObject(Extension.Data);
+		});
 	}
 }
 
@@ -124,18 +187,33 @@ FGameplayUIExtensionPointHandle UGameplayCommonExtensionSubsystem::RegisterExten
 
 	FExtensionPointList& List = ExtensionPointMap.FindOrAdd(ExtensionPointTag);
 
-	const TSharedPtr<FGameplayUIExtensionPoint>& Entry = List.Add_GetRef(MakeShared<FGameplayUIExtensionPoint>());
-	Entry->ExtensionPointTag = ExtensionPointTag;
-	Entry->ContextObject = ContextObject;
-	Entry->ExtensionPointTagMatchType = ExtensionPointTagMatchType;
-	Entry->AllowedDataClasses = AllowedDataClasses;
-	Entry->Callback = MoveTemp(ExtensionCallback);
+	const FGameplayUIExtensionSlotId EntryId = ExtensionPoints.Add();
+	FGameplayUIExtensionPoint& Entry = *ExtensionPoints.Find(EntryId);
+	Entry.ListIndex = List.Add(EntryId);
+	Entry.ExtensionPointTag = ExtensionPointTag;
+	Entry.ContextObject = ContextObject;
+	Entry.ExtensionPointTagMatchType = ExtensionPointTagMatchType;
+	Entry.AllowedDataClasses = AllowedDataClasses;
+	Entry.Callback = MoveTemp(ExtensionCallback);
 
 	UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension Point [%s] Registered"), *ExtensionPointTag.ToString());
 
-	NotifyExtensionPointOfExtensions(Entry);
+	AddExtensionPointToIndex(EntryId, Entry);
+	
+	INC_DWORD_STAT(STAT_GameplayUI_NumExtensionPoints);
+	CSV_CUSTOM_STAT(GameplayCommonUI, RegisteredExtensionPoints, ExtensionPoints.Num(), ECsvCustomStatOp::Set);
+
+	if (IsInExtensionBatch() || bFlushingExtensionBatch)
+	{
+		// The point receives the current state right away, so it must skip everything queued before it existed.
+		// A round being flushed right now is skipped entirely, see FlushPendingNotifications.
+		Entry.BatchRound = PendingBatchRound;
+		Entry.BatchSequence = PendingNotifications.Num();
+	}
 
-	return FGameplayUIExtensionPointHandle(this, Entry);
+	NotifyExtensionPointOfExtensions(EntryId);
+
+	return FGameplayUIExtensionPointHandle(this, EntryId);
 }
 
 FGameplayUIExtensionHandle UGameplayCommonExtensionSubsystem::RegisterExtensionAsWidgetInternal(const FGameplayTag& ExtensionPointTag, TSubclassOf<UUserWidget> WidgetClass, int32 Priority)
@@ -164,11 +242,16 @@ FGameplayUIExtensionHandle UGameplayCommonExtensionSubsystem::RegisterExtensionA
 
 	FExtensionList& List = ExtensionMap.FindOrAdd(ExtensionPointTag);
 
-	const TSharedPtr<FGameplayUIExtension>& Entry = List.Add_GetRef(MakeShared<FGameplayUIExtension>());
-	Entry->ExtensionPointTag = ExtensionPointTag;
-	Entry->ContextObject = ContextObject;
-	Entry->Data = Data;
-	Entry->Priority = Priority;
+	const FGameplayUIExtensionSlotId EntryId = Extensions.Add();
+	FGameplayUIExtension& Entry = *Extensions.Find(EntryId);
+	Entry.ListIndex = List.Add(EntryId);
+	Entry.ExtensionPointTag = ExtensionPointTag;
+	Entry.ContextObject = ContextObject;
+	Entry.Data = Data;
+	Entry.Priority = Priority;
+	
+	INC_DWORD_STAT(STAT_GameplayUI_NumExtensions);
+	CSV_CUSTOM_STAT(GameplayCommonUI, RegisteredExtensions, Extensions.Num(), ECsvCustomStatOp::Set);
 
 	if (ContextObject)
 	{
@@ -179,9 +262,20 @@ FGameplayUIExtensionHandle UGameplayCommonExtensionSubsystem::RegisterExtensionA
 		UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension [%s] for [%s] @ [%s] Registered"), *GetNameSafe(Data), *GetNameSafe(ContextObject), *ExtensionPointTag.ToString());
 	}
 
-	NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction::Added, Entry);
+	if (IsInExtensionBatch())
+	{
+		FPendingExtensionNotification& Notification = PendingNotifications.AddDefaulted_GetRef();
+		Notification.ExtensionAction = EGameplayUIExtensionAction::Added;
+		Notification.ExtensionId = EntryId;
+
+		PendingAddedIndices.Add(EntryId, PendingNotifications.Num() - 1);
+	}
+	else
+	{
+		NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction::Added, EntryId);
+	}
 
-	return FGameplayUIExtensionHandle(this, Entry);
+	return FGameplayUIExtensionHandle(this, EntryId);
 }
 
 void UGameplayCommonExtensionSubsystem::UnregisterExtension(const FGameplayUIExtensionHandle& ExtensionHandle)
@@ -190,25 +284,65 @@ void UGameplayCommonExtensionSubsystem::UnregisterExtension(const FGameplayUIExt
 	{
 		checkf(ExtensionHandle.ExtensionSource == this, TEXT("Trying to unregister an extension that's not from this extension subsystem."));
 
-		const TSharedPtr<FGameplayUIExtension> Extension = ExtensionHandle.DataPtr;
-		if (FExtensionList* ListPtr = ExtensionMap.Find(Extension->ExtensionPointTag))
+		const FGameplayUIExtensionSlotId ExtensionId = ExtensionHandle.SlotId;
+		if (IsExtensionRegistered(ExtensionId))
 		{
-			if (Extension->ContextObject.IsExplicitlyNull())
+			const FGameplayUIExtension& Extension = *Extensions.Find(ExtensionId);
+			const FGameplayTag ExtensionPointTag = Extension.ExtensionPointTag;
+			
+			if (Extension.ContextObject.IsExplicitlyNull())
 			{
-				UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension [%s] @ [%s] Unregistered"), *GetNameSafe(Extension->Data), *Extension->ExtensionPointTag.ToString());
+				UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension [%s] @ [%s] Unregistered"), *GetNameSafe(Extension.Data), *ExtensionPointTag.ToString());
 			}
 			else
 			{
-				UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension [%s] for [%s] @ [%s] Unregistered"), *GetNameSafe(Extension->Data), *GetNameSafe(Extension->ContextObject.Get()), *Extension->ExtensionPointTag.ToString());
+				UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension [%s] for [%s] @ [%s] Unregistered"), *GetNameSafe(Extension.Data), *GetNameSafe(Extension.ContextObject.Get()), *ExtensionPointTag.ToString());
 			}
 
-			NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction::Removed, Extension);
+			const bool bDeferFree = IsInExtensionBatch();
+			if (bDeferFree)
+			{
+				FPendingExtensionNotification Notification;
+				Notification.ExtensionAction = EGameplayUIExtensionAction::Removed;
+				Notification.ExtensionId = ExtensionId;
 
-			ListPtr->RemoveSwap(Extension);
-			
-			if (ListPtr->Num() == 0)
+				int32 PendingAddedIndex = INDEX_NONE;
+				if (PendingAddedIndices.RemoveAndCopyValue(ExtensionId, PendingAddedIndex))
+				{
+					// The addition was never delivered, so only points registered after it inside the batch have seen it.
+					PendingNotifications[PendingAddedIndex].ExtensionId = FGameplayUIExtensionSlotId();
+					Notification.MinPointSequence = PendingAddedIndex + 1;
+				}
+
+				PendingNotifications.Add(MoveTemp(Notification));
+				
+				// The queued notification still reads the extension, so its slot is only freed once the batch is flushed.
+				PendingFreeExtensions.Add(ExtensionId);
+			}
+			else
 			{
-				ExtensionMap.Remove(Extension->ExtensionPointTag);
+				NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction::Removed, ExtensionId);
+			}
+
+			// Look the list up only now, the callbacks may have registered extensions and reallocated the map.
+			// A callback unregistering this same extension again has already removed it.
+			FExtensionList* ListPtr = ExtensionMap.Find(ExtensionPointTag);
+			if (ListPtr && IsExtensionRegistered(ExtensionId))
+			{
+				RemoveFromTagList(*ListPtr, Extensions, *Extensions.Find(ExtensionId));
+				DEC_DWORD_STAT(STAT_GameplayUI_NumExtensions);
+				
+				if (ListPtr->Num() == 0)
+				{
+					ExtensionMap.Remove(ExtensionPointTag);
+				}
+				
+				if (!bDeferFree)
+				{
+					Extensions.Remove(ExtensionId);
+				}
+				
+				CSV_CUSTOM_STAT(GameplayCommonUI, RegisteredExtensions, Extensions.Num(), ECsvCustomStatOp::Set);
 			}
 		}
 	}
@@ -224,16 +358,36 @@ void UGameplayCommonExtensionSubsystem::UnregisterExtensionPoint(const FGameplay
 	{
 		check(ExtensionPointHandle.ExtensionSource == this);
 
-		const TSharedPtr<FGameplayUIExtensionPoint> ExtensionPoint = ExtensionPointHandle.DataPtr;
-		if (FExtensionPointList* ListPtr = ExtensionPointMap.Find(ExtensionPoint->ExtensionPointTag))
+		const FGameplayUIExtensionSlotId ExtensionPointId = ExtensionPointHandle.SlotId;
+		FGameplayUIExtensionPoint* ExtensionPoint = ExtensionPoints.Find(ExtensionPointId);
+		FExtensionPointList* ListPtr = ExtensionPoint ? ExtensionPointMap.Find(ExtensionPoint->ExtensionPointTag) : nullptr;
+		if (ListPtr && ExtensionPoint->ListIndex != INDEX_NONE)
 		{
-			UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension Point [%s] Unregistered"), *ExtensionPoint->ExtensionPointTag.ToString());
+			const FGameplayTag ExtensionPointTag = ExtensionPoint->ExtensionPointTag;
+			
+			UE_LOG(LogGameplayUIExtensionSubsystem, Verbose, TEXT("Extension Point [%s] Unregistered"), *ExtensionPointTag.ToString());
 
-			ListPtr->RemoveSwap(ExtensionPoint);
+			RemoveFromTagList(*ListPtr, ExtensionPoints, *ExtensionPoint);
+			DEC_DWORD_STAT(STAT_GameplayUI_NumExtensionPoints);
+			
 			if (ListPtr->Num() == 0)
 			{
-				ExtensionPointMap.Remove(ExtensionPoint->ExtensionPointTag);
+				ExtensionPointMap.Remove(ExtensionPointTag);
+			}
+
+			RemoveExtensionPointFromIndex(ExtensionPointId, *ExtensionPoint);
+			
+			// A point unregistering from inside a callback must outlive the delegate currently executing.
+			if (ExtensionPointCallbackDepth > 0)
+			{
+				PendingFreeExtensionPoints.Add(ExtensionPointId);
+			}
+			else
+			{
+				ExtensionPoints.Remove(ExtensionPointId);
 			}
+			
+			CSV_CUSTOM_STAT(GameplayCommonUI, RegisteredExtensionPoints, ExtensionPoints.Num(), ECsvCustomStatOp::Set);
 		}
 	}
 	else
@@ -242,69 +396,406 @@ void UGameplayCommonExtensionSubsystem::UnregisterExtensionPoint(const FGameplay
 	}
 }
 
-FGameplayUIExtensionRequest UGameplayCommonExtensionSubsystem::CreateExtensionRequest(const TSharedPtr<FGameplayUIExtension>& Extension)
+void UGameplayCommonExtensionSubsystem::BeginExtensionBatch()
 {
-	FGameplayUIExtensionRequest Request;
-	Request.ExtensionHandle = FGameplayUIExtensionHandle(this, Extension);
-	Request.ExtensionPointTag = Extension->ExtensionPointTag;
-	Request.Priority = Extension->Priority;
-	Request.Data = Extension->Data;
-	Request.ContextObject = Extension->ContextObject.Get();
+	++ExtensionBatchDepth;
+}
 
-	return Request;
+void UGameplayCommonExtensionSubsystem::EndExtensionBatch()
+{
+	if (!ensureMsgf(ExtensionBatchDepth > 0, TEXT("EndExtensionBatch called without a matching BeginExtensionBatch.")))
+	{
+		return;
+	}
+
+	// A batch closed from inside a flush callback is delivered by the outer flush once the current round returns.
+	if (--ExtensionBatchDepth == 0 && !bFlushingExtensionBatch)
+	{
+		FlushPendingNotifications();
+	}
 }
 
-void UGameplayCommonExtensionSubsystem::NotifyExtensionPointOfExtensions(const TSharedPtr<FGameplayUIExtensionPoint>& ExtensionPoint)
+void UGameplayCommonExtensionSubsystem::FlushPendingNotifications()
 {
-	for (FGameplayTag Tag = ExtensionPoint->ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	SCOPE_CYCLE_COUNTER(STAT_GameplayUI_FlushExtensionBatch);
+	CSV_SCOPED_TIMING_STAT(GameplayCommonUI, FlushExtensionBatch);
+	
+	TGuardValue<bool> FlushGuard(bFlushingExtensionBatch, true);
+	
+	// Callbacks may open and close batches of their own, those queue the next round instead of flushing re-entrantly.
+	while (!IsInExtensionBatch() && (!PendingNotifications.IsEmpty() || !PendingFreeExtensions.IsEmpty()))
 	{
-		if (const FExtensionList* ListPtr = ExtensionMap.Find(Tag))
+		// Take the whole round before dispatching so callbacks start from a clean queue.
+		const uint32 FlushRound = PendingBatchRound++;
+		
+		const TArray<FPendingExtensionNotification> Notifications = MoveTemp(PendingNotifications);
+		PendingNotifications.Reset();
+		PendingAddedIndices.Reset();
+		
+		const TArray<FGameplayUIExtensionSlotId> ExtensionsToFree = MoveTemp(PendingFreeExtensions);
+		PendingFreeExtensions.Reset();
+
+		// Group the queue by tag, then order each group by priority keeping registration order between equal priorities.
+		TMap<FGameplayTag, TArray<int32>> NotificationsByTag;
+		for (int32 NotificationIndex = 0; NotificationIndex < Notifications.Num(); ++NotificationIndex)
+		{
+			if (const FGameplayUIExtension* Extension = Extensions.Find(Notifications[NotificationIndex].ExtensionId))
+			{
+				NotificationsByTag.FindOrAdd(Extension->ExtensionPointTag).Add(NotificationIndex);
+			}
+		}
+
+		for (TPair<FGameplayTag, TArray<int32>>& TagNotifications : NotificationsByTag)
+		{
+			Algo::StableSortBy(TagNotifications.Value, [this, &Notifications](int32 NotificationIndex)
+			{
+				return Extensions.Find(Notifications[NotificationIndex].ExtensionId)->Priority;
+			}, TGreater<>());
+		}
+
+		for (const TPair<FGameplayTag, TArray<int32>>& TagNotifications : NotificationsByTag)
 		{
 			// Copy in case there are removals while handling callbacks
-			FExtensionList ExtensionArray(*ListPtr);
+			const FExtensionPointIndexList ExtensionPointArray(GetExtensionPointsForTag(TagNotifications.Key));
 
-			for (const TSharedPtr<FGameplayUIExtension>& Extension : ExtensionArray)
+			for (const FGameplayUIExtensionIndexEntry& IndexEntry : ExtensionPointArray)
 			{
-				if (ExtensionPoint->DoesExtensionPassContract(Extension.Get()))
+				const FGameplayUIExtensionSlotId& ExtensionPointId = IndexEntry.ExtensionPointId;
+				for (const int32 NotificationIndex : TagNotifications.Value)
 				{
-					FGameplayUIExtensionRequest Request = CreateExtensionRequest(Extension);
-					ExtensionPoint->Callback.ExecuteIfBound(EGameplayUIExtensionAction::Added, Request);
+					// An earlier callback may have unregistered the point.
+					const FGameplayUIExtensionPoint* ExtensionPoint = FindRegisteredExtensionPoint(ExtensionPointId);
+					if (!ExtensionPoint)
+					{
+						break;
+					}
+					
+					// Points registered while this round is being delivered already received its state.
+					if (ExtensionPoint->BatchRound == FlushRound + 1)
+					{
+						break;
+					}
+					
+					const FPendingExtensionNotification& Notification = Notifications[NotificationIndex];
+					
+					// Skip notifications the point already observed when it was registered.
+					const int32 PointSequence = ExtensionPoint->BatchRound == FlushRound ? ExtensionPoint->BatchSequence : INDEX_NONE;
+					if (PointSequence > NotificationIndex || PointSequence < Notification.MinPointSequence)
+					{
+						continue;
+					}
+
+					// An extension unregistered by an earlier callback of this flush already notified its removal.
+					if (Notification.ExtensionAction == EGameplayUIExtensionAction::Added && !IsExtensionRegistered(Notification.ExtensionId))
+					{
+						continue;
+					}
+
+					const FGameplayUIExtension* Extension = Extensions.Find(Notification.ExtensionId);
+					if (Extension && ExtensionPoint->DoesExtensionPassContract(Extension))
+					{
+						const FGameplayUIExtensionRequest Request = CreateExtensionRequest(Notification.ExtensionId, *Extension);
+						ExecuteExtensionPointCallback(*ExtensionPoint, Notification.ExtensionAction, Request);
+					}
 				}
 			}
 		}
 
-		if (ExtensionPoint->ExtensionPointTagMatchType == EGameplayUIExtensionPointMatch::ExactMatch)
+		for (const FGameplayUIExtensionSlotId& ExtensionId : ExtensionsToFree)
+		{
+			Extensions.Remove(ExtensionId);
+		}
+	}
+}
+
+bool UGameplayCommonExtensionSubsystem::IsExtensionRegistered(const FGameplayUIExtensionSlotId& ExtensionId) const
+{
+	const FGameplayUIExtension* Extension = Extensions.Find(ExtensionId);
+	return Extension && Extension->ListIndex != INDEX_NONE;
+}
+
+const FGameplayUIExtensionPoint* UGameplayCommonExtensionSubsystem::FindRegisteredExtensionPoint(const FGameplayUIExtensionSlotId& ExtensionPointId) const
+{
+	const FGameplayUIExtensionPoint* ExtensionPoint = ExtensionPoints.Find(ExtensionPointId);
+	return ExtensionPoint && ExtensionPoint->ListIndex != INDEX_NONE ? ExtensionPoint : nullptr;
+}
+
+void UGameplayCommonExtensionSubsystem::ExecuteExtensionPointCallback(const FGameplayUIExtensionPoint& ExtensionPoint, EGameplayUIExtensionAction ExtensionAction, const FGameplayUIExtensionRequest& Request)
+{
+	INC_DWORD_STAT(STAT_GameplayUI_ExtensionNotifications);
+	CSV_CUSTOM_STAT(GameplayCommonUI, ExtensionNotifications, 1, ECsvCustomStatOp::Accumulate);
+#if !UE_BUILD_SHIPPING
+	++NotificationCountsByTag.FindOrAdd(Request.ExtensionPointTag);
+#endif
+	
+	++ExtensionPointCallbackDepth;
+	ExtensionPoint.Callback.ExecuteIfBound(ExtensionAction, Request);
+	
+	if (--ExtensionPointCallbackDepth == 0 && !PendingFreeExtensionPoints.IsEmpty())
+	{
+		for (const FGameplayUIExtensionSlotId& ExtensionPointId : PendingFreeExtensionPoints)
+		{
+			ExtensionPoints.Remove(ExtensionPointId);
+		}
+		PendingFreeExtensionPoints.Reset();
+	}
+}
+
+FGameplayUIExtensionRequest UGameplayCommonExtensionSubsystem::CreateExtensionRequest(const FGameplayUIExtensionSlotId& ExtensionId, const FGameplayUIExtension& Extension)
+{
+	FGameplayUIExtensionRequest Request;
+	Request.ExtensionHandle = FGameplayUIExtensionHandle(this, ExtensionId);
+	Request.ExtensionPointTag = Extension.ExtensionPointTag;
+	Request.Priority = Extension.Priority;
+	Request.Data = Extension.Data;
+	Request.ContextObject = Extension.ContextObject.Get();
+
+	return Request;
+}
+
+void UGameplayCommonExtensionSubsystem::NotifyExtensionPointOfExtensions(const FGameplayUIExtensionSlotId& ExtensionPointId)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameplayUI_NotifyPointOfExtensions);
+	CSV_SCOPED_TIMING_STAT(GameplayCommonUI, NotifyPointOfExtensions);
+	
+	const FGameplayUIExtensionPoint* InitialExtensionPoint = FindRegisteredExtensionPoint(ExtensionPointId);
+	if (!InitialExtensionPoint)
+	{
+		return;
+	}
+	
+	const FGameplayTag ExtensionPointTag = InitialExtensionPoint->ExtensionPointTag;
+	const bool bExactMatch = InitialExtensionPoint->ExtensionPointTagMatchType == EGameplayUIExtensionPointMatch::ExactMatch;
+	
+	// Gather the whole tag chain first so the point receives its extensions in priority order.
+	// This is also the copy that protects us from removals while handling callbacks.
+	FExtensionList ExtensionArray;
+	for (FGameplayTag Tag = ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		if (const FExtensionList* ListPtr = ExtensionMap.Find(Tag))
+		{
+			ExtensionArray.Append(*ListPtr);
+		}
+
+		if (bExactMatch)
+		{
+			break;
+		}
+	}
+	
+	Algo::StableSortBy(ExtensionArray, [this](const FGameplayUIExtensionSlotId& ExtensionId)
+	{
+		return Extensions.Find(ExtensionId)->Priority;
+	}, TGreater<>());
+
+	for (const FGameplayUIExtensionSlotId& ExtensionId : ExtensionArray)
+	{
+		// The callback may unregister the point itself.
+		const FGameplayUIExtensionPoint* ExtensionPoint = FindRegisteredExtensionPoint(ExtensionPointId);
+		if (!ExtensionPoint)
+		{
+			return;
+		}
+		
+		if (!IsExtensionRegistered(ExtensionId))
+		{
+			continue;
+		}
+		
+		const FGameplayUIExtension& Extension = *Extensions.Find(ExtensionId);
+		if (ExtensionPoint->DoesExtensionPassContract(&Extension))
+		{
+			const FGameplayUIExtensionRequest Request = CreateExtensionRequest(ExtensionId, Extension);
+			ExecuteExtensionPointCallback(*ExtensionPoint, EGameplayUIExtensionAction::Added, Request);
+		}
+	}
+}
+
+void UGameplayCommonExtensionSubsystem::NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction ExtensionAction, const FGameplayUIExtensionSlotId& ExtensionId)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameplayUI_NotifyPointsOfExtension);
+	CSV_SCOPED_TIMING_STAT(GameplayCommonUI, NotifyPointsOfExtension);
+	
+	const FGameplayUIExtension* Extension = Extensions.Find(ExtensionId);
+	if (!Extension)
+	{
+		return;
+	}
+	
+	// Every point receives the same request, build it once.
+	const FGameplayUIExtensionRequest Request = CreateExtensionRequest(ExtensionId, *Extension);
+	
+	// Copy in case there are removals while handling callbacks
+	const FExtensionPointIndexList ExtensionPointArray(GetExtensionPointsForTag(Extension->ExtensionPointTag));
+
+	for (const FGameplayUIExtensionIndexEntry& IndexEntry : ExtensionPointArray)
+	{
+		const FGameplayUIExtensionSlotId& ExtensionPointId = IndexEntry.ExtensionPointId;
+		// A callback may have unregistered the extension, which already delivered its removal.
+		Extension = Extensions.Find(ExtensionId);
+		if (!Extension || (ExtensionAction == EGameplayUIExtensionAction::Added && Extension->ListIndex == INDEX_NONE))
 		{
 			break;
 		}
+		
+		const FGameplayUIExtensionPoint* ExtensionPoint = FindRegisteredExtensionPoint(ExtensionPointId);
+		if (ExtensionPoint && ExtensionPoint->DoesExtensionPassContract(Extension))
+		{
+			ExecuteExtensionPointCallback(*ExtensionPoint, ExtensionAction, Request);
+		}
 	}
 }
 
-void UGameplayCommonExtensionSubsystem::NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction ExtensionAction, const TSharedPtr<FGameplayUIExtension>& Extension)
+const UGameplayCommonExtensionSubsystem::FExtensionPointIndexList& UGameplayCommonExtensionSubsystem::GetExtensionPointsForTag(const FGameplayTag& ExtensionTag)
 {
+	if (const FExtensionPointIndexList* IndexedList = ExtensionPointIndex.Find(ExtensionTag))
+	{
+		return *IndexedList;
+	}
+
+	// Walk the tag chain once and flatten it. Tags without any matching point are not cached, 
+	// so looking up arbitrary extension tags can't grow the index.
+	FExtensionPointIndexList MatchingPoints;
+	
 	bool bOnInitialTag = true;
-	for (FGameplayTag Tag = Extension->ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	for (FGameplayTag Tag = ExtensionTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
 	{
 		if (const FExtensionPointList* ListPtr = ExtensionPointMap.Find(Tag))
 		{
-			// Copy in case there are removals while handling callbacks
-			FExtensionPointList ExtensionPointArray(*ListPtr);
-
-			for (const TSharedPtr<FGameplayUIExtensionPoint>& ExtensionPoint : ExtensionPointArray)
+			for (const FGameplayUIExtensionSlotId& ExtensionPointId : *ListPtr)
 			{
+				FGameplayUIExtensionPoint* ExtensionPoint = ExtensionPoints.Find(ExtensionPointId);
 				if (bOnInitialTag || (ExtensionPoint->ExtensionPointTagMatchType == EGameplayUIExtensionPointMatch::PartialMatch))
 				{
-					if (ExtensionPoint->DoesExtensionPassContract(Extension.Get()))
-					{
-						FGameplayUIExtensionRequest Request = CreateExtensionRequest(Extension);
-						ExtensionPoint->Callback.ExecuteIfBound(ExtensionAction, Request);
-					}
+					AddToIndexList(MatchingPoints, ExtensionTag, ExtensionPointId, *ExtensionPoint);
 				}
 			}
 		}
-		
+
 		bOnInitialTag = false;
 	}
+
+	if (MatchingPoints.IsEmpty())
+	{
+		static const FExtensionPointIndexList EmptyList;
+		return EmptyList;
+	}
+
+	return ExtensionPointIndex.Add(ExtensionTag, MoveTemp(MatchingPoints));
+}
+
+void UGameplayCommonExtensionSubsystem::AddToIndexList(FExtensionPointIndexList& IndexList, const FGameplayTag& IndexTag, const FGameplayUIExtensionSlotId& ExtensionPointId, FGameplayUIExtensionPoint& ExtensionPoint)
+{
+	FGameplayUIExtensionIndexEntry& IndexEntry = IndexList.AddDefaulted_GetRef();
+	IndexEntry.ExtensionPointId = ExtensionPointId;
+	IndexEntry.PositionIndex = ExtensionPoint.IndexPositions.Add(FGameplayUIExtensionIndexPosition{IndexTag, IndexList.Num() - 1});
+}
+
+void UGameplayCommonExtensionSubsystem::AddExtensionPointToIndex(const FGameplayUIExtensionSlotId& ExtensionPointId, FGameplayUIExtensionPoint& ExtensionPoint)
+{
+	if (ExtensionPointIndex.IsEmpty())
+	{
+		return;
+	}
+	
+	// Tags without an entry pick the point up when their entry is built.
+	const FGameplayTag& PointTag = ExtensionPoint.ExtensionPointTag;
+	if (FExtensionPointIndexList* IndexedList = ExtensionPointIndex.Find(PointTag))
+	{
+		AddToIndexList(*IndexedList, PointTag, ExtensionPointId, ExtensionPoint);
+	}
+
+	if (ExtensionPoint.ExtensionPointTagMatchType == EGameplayUIExtensionPointMatch::PartialMatch)
+	{
+		for (const FGameplayTag& ChildTag : UGameplayTagsManager::Get().RequestGameplayTagChildren(PointTag))
+		{
+			if (FExtensionPointIndexList* IndexedList = ExtensionPointIndex.Find(ChildTag))
+			{
+				AddToIndexList(*IndexedList, ChildTag, ExtensionPointId, ExtensionPoint);
+			}
+		}
+	}
+}
+
+void UGameplayCommonExtensionSubsystem::RemoveExtensionPointFromIndex(const FGameplayUIExtensionSlotId& ExtensionPointId, FGameplayUIExtensionPoint& ExtensionPoint)
+{
+	// Each list is fixed up like the per-tag lists: swap the last entry into the freed position and repoint its record.
+	for (const FGameplayUIExtensionIndexPosition& IndexPosition : ExtensionPoint.IndexPositions)
+	{
+		FExtensionPointIndexList* IndexedList = ExtensionPointIndex.Find(IndexPosition.IndexTag);
+		const int32 ListIndex = IndexPosition.ListIndex;
+		if (!ensure(IndexedList && IndexedList->IsValidIndex(ListIndex) && (*IndexedList)[ListIndex].ExtensionPointId == ExtensionPointId))
+		{
+			continue;
+		}
+		
+		IndexedList->RemoveAtSwap(ListIndex, EAllowShrinking::No);
+		if (IndexedList->IsValidIndex(ListIndex))
+		{
+			const FGameplayUIExtensionIndexEntry& MovedEntry = (*IndexedList)[ListIndex];
+			ExtensionPoints.Find(MovedEntry.ExtensionPointId)->IndexPositions[MovedEntry.PositionIndex].ListIndex = ListIndex;
+		}
+		else if (IndexedList->IsEmpty())
+		{
+			ExtensionPointIndex.Remove(IndexPosition.IndexTag);
+		}
+	}
+	
+	ExtensionPoint.IndexPositions.Reset();
+}
+
+void UGameplayCommonExtensionSubsystem::OnShowDebugInfo(AHUD* HUD, UCanvas* Canvas, const FDebugDisplayInfo& DisplayInfo, float& YL, float& YPos)
+{
+	static const FName Name_CommonUI(TEXT("GameplayCommonUI"));
+	if (!Canvas || !HUD || HUD->GetWorld() != GetWorld() || !DisplayInfo.IsDisplayOn(Name_CommonUI))
+	{
+		return;
+	}
+	
+	const UFont* RenderFont = GEngine->GetSmallFont();
+	constexpr float LineHeight = 15.0f;
+	YL = LineHeight;
+	
+	constexpr FLinearColor ColorHeader(0.1f, 0.7f, 0.1f);
+	constexpr FLinearColor ColorTag(0.2f, 0.5f, 1.0f);
+	
+	auto DrawText = [&](const FString& Text, const FLinearColor& Color, float PosX)
+	{
+		FCanvasTextItem TextItem(FVector2D(PosX, YPos), FText::FromString(Text), RenderFont, Color);
+		TextItem.EnableShadow(FLinearColor::Black);
+		Canvas->DrawItem(TextItem);
+	};
+	
+	// HEADER
+	YPos += 5.0f;
+	DrawText(FString::Printf(TEXT("UI EXTENSIONS  [Points: %d  Extensions: %d]"), ExtensionPoints.Num(), Extensions.Num()), ColorHeader, 5.0f);
+	YPos += LineHeight + 5.0f;
+	
+	TSet<FGameplayTag> Tags;
+	ExtensionPointMap.GetKeys(Tags);
+	for (const TPair<FGameplayTag, FExtensionList>& ExtensionPair : ExtensionMap)
+	{
+		Tags.Add(ExtensionPair.Key);
+	}
+	
+	Tags.Sort([](const FGameplayTag& A, const FGameplayTag& B) { return A.GetTagName().LexicalLess(B.GetTagName()); });
+	
+	for (const FGameplayTag& Tag : Tags)
+	{
+		const FExtensionPointList* PointList = ExtensionPointMap.Find(Tag);
+		const FExtensionList* ExtensionList = ExtensionMap.Find(Tag);
+		
+		int32 NumNotifications = 0;
+#if !UE_BUILD_SHIPPING
+		NumNotifications = NotificationCountsByTag.FindRef(Tag);
+#endif
+		
+		DrawText(Tag.ToString(), ColorTag, 10.0f);
+		DrawText(FString::Printf(TEXT("Points: %d  Extensions: %d  Notifications: %d"), PointList ? PointList->Num() : 0, ExtensionList ? ExtensionList->Num() : 0, NumNotifications), FLinearColor::White, 320.0f);
+		YPos += LineHeight;
+	}
+	
+	YPos += 8.0f;
 }
 
 FGameplayUIExtensionPointHandle UGameplayCommonExtensionSubsystem::RegisterExtensionPoint(FGameplayTag ExtensionPointTag, EGameplayUIExtensionPointMatch ExtensionPointTagMatchType, const TArray<UClass*>& AllowedDataClasses, FGameplayExtendUIExtensionPointDynamicSignature ExtensionCallback)
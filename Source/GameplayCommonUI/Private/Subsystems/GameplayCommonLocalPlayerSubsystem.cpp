@@ -9,6 +9,19 @@
 #include "Engine/GameInstance.h"
 #include "Engine/LocalPlayer.h"
 #include "Widgets/GameplayConfirmationDialog.h"
+#include "CommonInputSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Misc/GameplayCommonStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGameplayLocalPlayerSubsystem, Log, All);
+
+namespace GameplayInputSuspension
+{
+	/** The single filter reason this subsystem writes to CommonInput, however many suspensions are held */
+	static const FName NAME_FilterReason(TEXT("GameplayCommonUI.InputSuspension"));
+}
 
 bool UGameplayCommonLocalPlayerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 {
@@ -27,21 +40,35 @@ bool UGameplayCommonLocalPlayerSubsystem::ShouldCreateSubsystem(UObject* Outer)
 void UGameplayCommonLocalPlayerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+	
+	// The player controller is still on its way, which leaves time to build the layout before it is needed.
+	if (const UGameInstance* GameInstance = GetLocalPlayer()->GetGameInstance())
+	{
+		if (UGameplayCommonUISubsystem* UIManagerSubsystem = GameInstance->GetSubsystem<UGameplayCommonUISubsystem>())
+		{
+			UIManagerSubsystem->NotifyPlayerCreated(GetLocalPlayer());
+		}
+	}
 }
 
 void UGameplayCommonLocalPlayerSubsystem::Deinitialize()
 {
+	if (IsInputSuspended())
+	{
+		InputSuspensionTokens.Reset();
+		ApplyInputSuspension(false);
+	}
+	
 	if (const UGameInstance* GameInstance = GetLocalPlayer()->GetGameInstance())
 	{
-		if (const UGameplayCommonUISubsystem* UIManagerSubsystem = GameInstance->GetSubsystem<UGameplayCommonUISubsystem>())
+		if (UGameplayCommonUISubsystem* UIManagerSubsystem = GameInstance->GetSubsystem<UGameplayCommonUISubsystem>())
 		{
-			if (UGameplayCommonUIPolicy* Policy = UIManagerSubsystem->GetUIPolicy())
-			{
-				Policy->NotifyPlayerDestroyed(GetLocalPlayer());
-			}
+			UIManagerSubsystem->NotifyPlayerDestroyed(GetLocalPlayer());
 		}
 	}
 	
+	StopWaitingForPlayerState();
+	
 	if (const UWorld* World = GetWorld())
 	{
 		World->GetTimerManager().ClearAllTimersForObject(this);
@@ -54,66 +81,174 @@ void UGameplayCommonLocalPlayerSubsystem::PlayerControllerChanged(APlayerControl
 {
 	Super::PlayerControllerChanged(NewPlayerController);
 	
-	// Stop any active timer from a previous controller to prevent conflicts.
-	if (const UWorld* World = GetWorld())
+	// Stop listening on behalf of a previous controller to prevent conflicts.
+	StopWaitingForPlayerState();
+	
+	if (APlayerController* OldPlayerController = WeakPlayerController.Get())
 	{
-		World->GetTimerManager().ClearTimer(TimerHandle_CheckPlayerState);
+		OldPlayerController->GetOnNewPawnNotifier().RemoveAll(this);
 	}
 
-	// If the controller is being removed (nullptr), we just return after clearing the timer.
+	// If the controller is being removed (nullptr), we are done.
+	WeakPlayerController = NewPlayerController;
 	if (!NewPlayerController)
 	{
-		WeakPlayerController = nullptr;
 		return;
 	}
 
-	// Store a weak reference to the new controller for safe async access.
-	WeakPlayerController = NewPlayerController;
+	// The player state is usually already valid on server and standalone, clients may still be waiting for it to replicate.
+	PlayerStateWaitStartTime = FPlatformTime::Seconds();
+	PlayerStateTimeToReady = -1.0;
+	if (!TryNotifyPlayerStateReady())
+	{
+		WaitForPlayerState(NewPlayerController->GetWorld());
+	}
+		
+	NewPlayerController->GetOnNewPawnNotifier().AddUObject(this, &ThisClass::HandlePawnChanged);
+		
+	// Routed through the UI subsystem so players added while the policy is still loading are picked up once it is ready.
+	if (UGameplayCommonUISubsystem* UIManagerSubsystem = UGameplayCommonUISubsystem::Get(NewPlayerController))
+	{
+		UIManagerSubsystem->NotifyPlayerAdded(GetLocalPlayer());
+	}
+		
+	if (APawn* CurrentControlledPawn = NewPlayerController->GetPawn())
+	{
+		HandlePawnChanged(CurrentControlledPawn);
+	}
+}
+
+void UGameplayCommonLocalPlayerSubsystem::NotifyPlayerStateChanged()
+{
+	if (PlayerStateTimeToReady < 0.0)
+	{
+		TryNotifyPlayerStateReady();
+	}
+}
+
+bool UGameplayCommonLocalPlayerSubsystem::TryNotifyPlayerStateReady()
+{
+	const APlayerController* PlayerController = WeakPlayerController.Get();
+	if (!PlayerController || !PlayerController->PlayerState)
+	{
+		return false;
+	}
+	
+	StopWaitingForPlayerState();
+	
+	PlayerStateTimeToReady = FPlatformTime::Seconds() - PlayerStateWaitStartTime;
+	CSV_CUSTOM_STAT(GameplayCommonUI, PlayerStateReadyMs, PlayerStateTimeToReady * 1000.0, ECsvCustomStatOp::Set);
+	UE_LOG(LogGameplayLocalPlayerSubsystem, Verbose, TEXT("PlayerState of [%s] ready after %.2f ms"), *GetNameSafe(GetLocalPlayer()), PlayerStateTimeToReady * 1000.0);
+	
+	OnLocalPlayerStateSet.Broadcast(PlayerController->PlayerState);
+	return true;
+}
 
-	// Check if the PlayerState is already valid (Common on Server or Standalone).
-	if (NewPlayerController->PlayerState)
+void UGameplayCommonLocalPlayerSubsystem::WaitForPlayerState(UWorld* World)
+{
+	if (!World)
 	{
-		OnLocalPlayerStateSet.Broadcast(NewPlayerController->PlayerState);
+		return;
 	}
-	else
+	
+	PlayerStateWaitWorld = World;
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::HandleActorSpawned));
+	
+	// Safety net for player states that arrive without being spawned on this side, e.g. when carried over by seamless travel.
+	constexpr float TimeoutSeconds = 5.0f;
+	constexpr bool bLoop = false;
+	World->GetTimerManager().SetTimer(TimerHandle_PlayerStateTimeout, this, &ThisClass::HandlePlayerStateTimeout, TimeoutSeconds, bLoop);
+}
+
+void UGameplayCommonLocalPlayerSubsystem::StopWaitingForPlayerState()
+{
+	if (UWorld* World = PlayerStateWaitWorld.Get())
 	{
-		// PlayerState is not ready yet (Common on Client). Start a safe polling timer.
-		if (const UWorld* World = GetWorld())
+		World->GetTimerManager().ClearTimer(TimerHandle_PlayerStateTimeout);
+		World->GetTimerManager().ClearTimer(TimerHandle_PlayerStateNextTick);
+		
+		if (ActorSpawnedHandle.IsValid())
 		{
-			// Checking every 0.1s is responsive enough for UI without hitting performance.
-			constexpr float CheckInterval = 0.1f;
-			constexpr bool bLoop = true;
-			World->GetTimerManager().SetTimer(TimerHandle_CheckPlayerState, this, &ThisClass::CheckPlayerStateValidity, CheckInterval, bLoop);
+			World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
 		}
 	}
+	PlayerStateWaitWorld.Reset();
+	ActorSpawnedHandle.Reset();
+}
+
+void UGameplayCommonLocalPlayerSubsystem::HandleActorSpawned(AActor* SpawnedActor)
+{
+	if (!Cast<APlayerState>(SpawnedActor))
+	{
+		return;
+	}
 	
-	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_CheckPlayerState);
-		
-	if (NewPlayerController->PlayerState)
+	// Player states of other players are of no interest. A replicated one may not have received its owner yet, so only 
+	// skip those that are known to belong to another controller.
+	const AActor* PlayerStateOwner = SpawnedActor->GetOwner();
+	if ((PlayerStateOwner && PlayerStateOwner != WeakPlayerController.Get()) || TryNotifyPlayerStateReady())
 	{
-		OnLocalPlayerStateSet.Broadcast(NewPlayerController->PlayerState);
+		return;
 	}
-	else
+	
+	CheckPlayerStateNextTick();
+}
+
+void UGameplayCommonLocalPlayerSubsystem::CheckPlayerStateNextTick()
+{
+	UWorld* World = PlayerStateWaitWorld.Get();
+	if (!World || World->GetTimerManager().TimerExists(TimerHandle_PlayerStateNextTick))
 	{
-		GetWorld()->GetTimerManager().SetTimer(TimerHandle_CheckPlayerState, this, &ThisClass::CheckPlayerStateValidity, 0.1f, true);
+		return;
 	}
-		
-	NewPlayerController->GetOnNewPawnNotifier().AddUObject(this, &ThisClass::HandlePawnChanged);
-		
-	if (const UGameplayCommonUISubsystem* UIManagerSubsystem = UGameplayCommonUISubsystem::Get(NewPlayerController))
+	
+	// The controller's player state can be assigned several frames after the actor spawned, keep checking until it is.
+	TimerHandle_PlayerStateNextTick = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this]()
 	{
-		if (UGameplayCommonUIPolicy* Policy = UIManagerSubsystem->GetUIPolicy())
+		TimerHandle_PlayerStateNextTick.Invalidate();
+		if (WeakPlayerController.IsValid() && !TryNotifyPlayerStateReady())
 		{
-			Policy->NotifyPlayerAdded(GetLocalPlayer());
+			CheckPlayerStateNextTick();
 		}
+	}));
+}
+
+void UGameplayCommonLocalPlayerSubsystem::HandlePlayerStateTimeout()
+{
+	if (!WeakPlayerController.IsValid())
+	{
+		StopWaitingForPlayerState();
+		return;
 	}
-		
-	if (APawn* CurrentControlledPawn = NewPlayerController->GetPawn())
+	
+	if (TryNotifyPlayerStateReady())
 	{
-		HandlePawnChanged(CurrentControlledPawn);
+		return;
+	}
+	
+	UE_LOG(LogGameplayLocalPlayerSubsystem, Warning, TEXT("PlayerState of [%s] still missing after %.2f s, checking at a low frequency from now on"),
+		*GetNameSafe(GetLocalPlayer()), FPlatformTime::Seconds() - PlayerStateWaitStartTime);
+	
+	// Slow joins and seamless travel can take longer than the timeout, keep checking until it arrives without polling every frame.
+	if (UWorld* World = PlayerStateWaitWorld.Get())
+	{
+		constexpr float SlowCheckInterval = 1.0f;
+		constexpr bool bLoop = true;
+		World->GetTimerManager().SetTimer(TimerHandle_PlayerStateTimeout, this, &ThisClass::HandlePlayerStateSlowCheck, SlowCheckInterval, bLoop);
 	}
 }
 
+void UGameplayCommonLocalPlayerSubsystem::HandlePlayerStateSlowCheck()
+{
+	if (!WeakPlayerController.IsValid())
+	{
+		StopWaitingForPlayerState();
+		return;
+	}
+	
+	TryNotifyPlayerStateReady();
+}
+
 void UGameplayCommonLocalPlayerSubsystem::ShowConfirmation(UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback)
 {
 	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
@@ -122,15 +257,7 @@ void UGameplayCommonLocalPlayerSubsystem::ShowConfirmation(UGameplayConfirmation
 	const TSubclassOf<UGameplayConfirmationDialog> ConfirmationDialogClass = Settings->ConfirmationDialogClass.LoadSynchronous();
 	if (ensure(ConfirmationDialogClass))
 	{
-		UGameplayPrimaryLayout* PrimaryLayout = UGameplayPrimaryLayout::GetPrimaryGameLayout(GetLocalPlayer());
-		if (IsValid(PrimaryLayout))
-		{
-			PrimaryLayout->PushWidgetToLayerStack<UGameplayConfirmationDialog>(GameplayCommonTags::Layer_Modal, ConfirmationDialogClass, 
-			[Descriptor, ResultCallback](UGameplayConfirmationDialog& Dialog)
-			{
-				Dialog.SetupDialog(Descriptor, ResultCallback);
-			});
-		}
+		PushConfirmationDialog(ConfirmationDialogClass, Descriptor, ResultCallback);
 	}
 }
 
@@ -142,53 +269,141 @@ void UGameplayCommonLocalPlayerSubsystem::ShowError(UGameplayConfirmationDescrip
 	const TSubclassOf<UGameplayConfirmationDialog> ErrorDialogClass = Settings->ErrorDialogClass.LoadSynchronous();
 	if (ensure(ErrorDialogClass))
 	{
-		UGameplayPrimaryLayout* PrimaryLayout = UGameplayPrimaryLayout::GetPrimaryGameLayout(GetLocalPlayer());
-		if (IsValid(PrimaryLayout))
-		{
-			PrimaryLayout->PushWidgetToLayerStack<UGameplayConfirmationDialog>(GameplayCommonTags::Layer_Modal, ErrorDialogClass, 
-			[Descriptor, ResultCallback](UGameplayConfirmationDialog& Dialog)
-			{
-				Dialog.SetupDialog(Descriptor, ResultCallback);
-			});
-		}
+		PushConfirmationDialog(ErrorDialogClass, Descriptor, ResultCallback);
 	}
 }
 
-void UGameplayCommonLocalPlayerSubsystem::HandlePawnChanged(APawn* NewPawn)
+void UGameplayCommonLocalPlayerSubsystem::ShowConfirmationAsync(UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback)
 {
-	if (OnLocalPlayerPawnSet.IsBound())
+	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
+	check(Settings);
+	
+	ShowConfirmationDialogAsync(Settings->ConfirmationDialogClass, Descriptor, MoveTemp(ResultCallback));
+}
+
+void UGameplayCommonLocalPlayerSubsystem::ShowErrorAsync(UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback)
+{
+	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
+	check(Settings);
+	
+	ShowConfirmationDialogAsync(Settings->ErrorDialogClass, Descriptor, MoveTemp(ResultCallback));
+}
+
+bool UGameplayCommonLocalPlayerSubsystem::PushConfirmationDialog(TSubclassOf<UGameplayConfirmationDialog> DialogClass, UGameplayConfirmationDescriptor* Descriptor, const FGameplayConfirmationDialogResultSignature& ResultCallback) const
+{
+	UGameplayPrimaryLayout* PrimaryLayout = UGameplayPrimaryLayout::GetPrimaryGameLayout(GetLocalPlayer());
+	if (!IsValid(PrimaryLayout))
 	{
-		OnLocalPlayerPawnSet.Broadcast(NewPawn);
+		return false;
 	}
+	
+	const UGameplayConfirmationDialog* Dialog = PrimaryLayout->PushWidgetToLayerStack<UGameplayConfirmationDialog>(GameplayCommonTags::Layer_Modal, DialogClass, 
+	[Descriptor, ResultCallback](UGameplayConfirmationDialog& DialogToInit)
+	{
+		DialogToInit.SetupDialog(Descriptor, ResultCallback);
+	});
+	return Dialog != nullptr;
 }
 
-void UGameplayCommonLocalPlayerSubsystem::CheckPlayerStateValidity()
+void UGameplayCommonLocalPlayerSubsystem::ShowConfirmationDialogAsync(const TSoftClassPtr<UGameplayConfirmationDialog>& DialogClass, UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback)
 {
-	// Safety Check: If the controller was destroyed while waiting, stop the timer.
-	if (!WeakPlayerController.IsValid())
+	if (!ensure(!DialogClass.IsNull()))
+	{
+		ResultCallback.ExecuteIfBound(EGameplayConfirmationResult::Unknown);
+		return;
+	}
+	
+	// Preloaded at login by the UI subsystem, so this is the common path.
+	if (const TSubclassOf<UGameplayConfirmationDialog> LoadedDialogClass = DialogClass.Get())
 	{
-		if (const UWorld* World = GetWorld())
+		if (!PushConfirmationDialog(LoadedDialogClass, Descriptor, ResultCallback))
 		{
-			World->GetTimerManager().ClearTimer(TimerHandle_CheckPlayerState);
+			ResultCallback.ExecuteIfBound(EGameplayConfirmationResult::Unknown);
 		}
 		return;
 	}
 	
-	const APlayerController* ActualPlayerController = WeakPlayerController.Get();
+	UGameplayCommonUISubsystem* UIManager = GetLocalPlayer()->GetGameInstance()->GetSubsystem<UGameplayCommonUISubsystem>();
+	if (!UIManager)
+	{
+		ResultCallback.ExecuteIfBound(EGameplayConfirmationResult::Unknown);
+		return;
+	}
 	
-	// Resolve the weak pointer to access the controller safely.
-	if (ActualPlayerController && ActualPlayerController->PlayerState)
+	// Keep the descriptor alive while the class streams in, the caller may not be holding on to it.
+	TStrongObjectPtr<UGameplayConfirmationDescriptor> DescriptorRef(Descriptor);
+	UIManager->RequestSharedClassLoad(DialogClass.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this,
+	[this, DialogClass, DescriptorRef, ResultCallback]()
 	{
-		// SUCCESS: Stop the timer immediately.
-		if (const UWorld* World = GetWorld())
+		const TSubclassOf<UGameplayConfirmationDialog> LoadedDialogClass = DialogClass.Get();
+		if (!LoadedDialogClass || !PushConfirmationDialog(LoadedDialogClass, DescriptorRef.Get(), ResultCallback))
 		{
-			World->GetTimerManager().ClearTimer(TimerHandle_CheckPlayerState);
+			ResultCallback.ExecuteIfBound(EGameplayConfirmationResult::Unknown);
 		}
-		
-		// Broadcast the event to listeners.
-		OnLocalPlayerStateSet.Broadcast(ActualPlayerController->PlayerState);
-		
-		// Clear the weak reference as we don't need it for the timer anymore.
-		WeakPlayerController = nullptr;
+	}));
+}
+
+FName UGameplayCommonLocalPlayerSubsystem::SuspendInput(FName SuspendReason)
+{
+	FName SuspendToken = SuspendReason;
+	SuspendToken.SetNumber(++InputSuspensionSerial);
+	
+	InputSuspensionTokens.Add(SuspendToken);
+	if (InputSuspensionTokens.Num() == 1)
+	{
+		ApplyInputSuspension(true);
+	}
+	
+	return SuspendToken;
+}
+
+void UGameplayCommonLocalPlayerSubsystem::ResumeInput(FName SuspendToken)
+{
+	if (SuspendToken == NAME_None)
+	{
+		return;
+	}
+	
+	if (InputSuspensionTokens.RemoveSingle(SuspendToken) == 0)
+	{
+		UE_LOG(LogGameplayLocalPlayerSubsystem, Verbose, TEXT("Ignoring resume of unknown input suspension [%s]"), *SuspendToken.ToString());
+		return;
+	}
+	
+	if (InputSuspensionTokens.IsEmpty())
+	{
+		ApplyInputSuspension(false);
+	}
+}
+
+void UGameplayCommonLocalPlayerSubsystem::ApplyInputSuspension(bool bSuspended) const
+{
+	if (UCommonInputSubsystem* CommonInputSubsystem = UCommonInputSubsystem::Get(GetLocalPlayer()))
+	{
+		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::MouseAndKeyboard, GameplayInputSuspension::NAME_FilterReason, bSuspended);
+		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::Gamepad, GameplayInputSuspension::NAME_FilterReason, bSuspended);
+		CommonInputSubsystem->SetInputTypeFilter(ECommonInputType::Touch, GameplayInputSuspension::NAME_FilterReason, bSuspended);
+	}
+}
+
+void UGameplayCommonLocalPlayerSubsystem::HandlePawnChanged(APawn* NewPawn)
+{
+	// A possessed pawn usually arrives together with the player state on clients.
+	NotifyPlayerStateChanged();
+	
+	if (const UGameInstance* GameInstance = GetLocalPlayer()->GetGameInstance())
+	{
+		if (const UGameplayCommonUISubsystem* UIManagerSubsystem = GameInstance->GetSubsystem<UGameplayCommonUISubsystem>())
+		{
+			if (UGameplayCommonUIPolicy* Policy = UIManagerSubsystem->GetUIPolicy())
+			{
+				Policy->NotifyPawnChanged(GetLocalPlayer(), NewPawn);
+			}
+		}
+	}
+	
+	if (OnLocalPlayerPawnSet.IsBound())
+	{
+		OnLocalPlayerPawnSet.Broadcast(NewPawn);
 	}
 }
@@ -8,6 +8,8 @@
 #include "Engine/GameInstance.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/Engine.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 
 static TAutoConsoleVariable<bool> CVarShowDebugGameplayCommonUI(
 	TEXT("ShowDebug GameplayCommonUI"),
@@ -51,16 +53,43 @@ void UGameplayCommonUISubsystem::Initialize(FSubsystemCollectionBase& Collection
 		const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
 		check(Settings);
 
-		const TSubclassOf<UGameplayCommonUIPolicy> PolicyClass = Settings->GameplayUIPolicyClass.LoadSynchronous();
-		if (ensure(PolicyClass))
+		// Stream the policy and everything it references in while the game instance keeps booting.
+		if (Settings->GameplayUIPolicyClass.Get())
 		{
-			SwitchToPolicy(NewObject<UGameplayCommonUIPolicy>(this, PolicyClass));
+			HandleUIPolicyClassLoaded();
+		}
+		else if (!UAssetManager::IsInitialized())
+		{
+			// Nothing to stream it with, load it right here.
+			Settings->GameplayUIPolicyClass.LoadSynchronous();
+			HandleUIPolicyClassLoaded();
+		}
+		else
+		{
+			TSharedPtr<FStreamableHandle> LoadHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(Settings->GameplayUIPolicyClass.ToSoftObjectPath(),
+				FStreamableDelegate::CreateUObject(this, &ThisClass::HandleUIPolicyClassLoaded), FStreamableManager::AsyncLoadHighPriority);
+			
+			// The delegate may already have run from inside the request, only keep waiting if it hasn't.
+			if (!CurrentPolicy)
+			{
+				if (LoadHandle.IsValid())
+				{
+					UIPolicyLoadHandle = LoadHandle;
+				}
+				else
+				{
+					Settings->GameplayUIPolicyClass.LoadSynchronous();
+					HandleUIPolicyClassLoaded();
+				}
+			}
 		}
 	}
 	
 	if (!IsTemplate())
 	{
 		AHUD::OnShowDebugInfo.AddUObject(this, &ThisClass::OnShowDebugInfo);
+		
+		AlwaysResidentWidgetsHandle = LoadResidentWidgetClasses(EGameplayWidgetResidency::AlwaysResident);
 	}
 }
 
@@ -68,6 +97,55 @@ void UGameplayCommonUISubsystem::Deinitialize()
 {
 	AHUD::OnShowDebugInfo.RemoveAll(this);
 	
+	if (UIPolicyLoadHandle.IsValid())
+	{
+		UIPolicyLoadHandle->CancelHandle();
+		UIPolicyLoadHandle.Reset();
+	}
+	PendingPlayersAdded.Reset();
+	
+	// The policy will never be ready now, let every queued request clean up after itself.
+	TArray<FPendingPolicyRequest> CanceledRequests = MoveTemp(PendingPolicyRequests);
+	for (FPendingPolicyRequest& CanceledRequest : CanceledRequests)
+	{
+		if (CanceledRequest.OnCanceled)
+		{
+			CanceledRequest.OnCanceled();
+		}
+	}
+	
+	if (SweepSharedClassLoadsHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SweepSharedClassLoadsHandle);
+		SweepSharedClassLoadsHandle.Reset();
+	}
+	for (TPair<FSoftObjectPath, FSharedClassLoad>& SharedLoad : SharedClassLoads)
+	{
+		if (SharedLoad.Value.Handle.IsValid())
+		{
+			SharedLoad.Value.Handle->ReleaseHandle();
+		}
+	}
+	SharedClassLoads.Reset();
+	
+	if (AlwaysResidentWidgetsHandle.IsValid())
+	{
+		AlwaysResidentWidgetsHandle->ReleaseHandle();
+		AlwaysResidentWidgetsHandle.Reset();
+	}
+	
+	if (LoginPreloadWidgetsHandle.IsValid())
+	{
+		LoginPreloadWidgetsHandle->ReleaseHandle();
+		LoginPreloadWidgetsHandle.Reset();
+	}
+	
+	if (DialogClassesHandle.IsValid())
+	{
+		DialogClassesHandle->ReleaseHandle();
+		DialogClassesHandle.Reset();
+	}
+	
 	SwitchToPolicy(nullptr);
 	
 	Super::Deinitialize();
@@ -159,16 +237,85 @@ void UGameplayCommonUISubsystem::OnShowDebugInfo(AHUD* HUD, UCanvas* Canvas, con
 	}
 }
 
+TSharedPtr<FStreamableHandle> UGameplayCommonUISubsystem::LoadResidentWidgetClasses(EGameplayWidgetResidency Residency) const
+{
+	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
+	TArray<FSoftObjectPath> WidgetPaths = Settings->GetActivatableWidgetPaths(Residency);
+	if (WidgetPaths.IsEmpty() || !UAssetManager::IsInitialized())
+	{
+		return nullptr;
+	}
+	
+	// The handle is owned by the subsystem instead of the streamable manager, so the classes stay loaded until it is released.
+	constexpr bool bManageActiveHandle = false;
+	return UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(MoveTemp(WidgetPaths), FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority, bManageActiveHandle);
+}
+
+void UGameplayCommonUISubsystem::NotifyPlayerCreated(ULocalPlayer* LocalPlayer)
+{
+	CallOrQueueUntilPolicyReady([WeakThis = TWeakObjectPtr<ThisClass>(this), WeakLocalPlayer = TWeakObjectPtr<ULocalPlayer>(LocalPlayer)]()
+	{
+		if (WeakThis.IsValid() && WeakThis->CurrentPolicy && WeakLocalPlayer.IsValid())
+		{
+			WeakThis->CurrentPolicy->NotifyPlayerCreated(WeakLocalPlayer.Get());
+		}
+	});
+}
+
+void UGameplayCommonUISubsystem::PrewarmPrimaryLayout(ULocalPlayer* LocalPlayer)
+{
+	CallOrQueueUntilPolicyReady([WeakThis = TWeakObjectPtr<ThisClass>(this), WeakLocalPlayer = TWeakObjectPtr<ULocalPlayer>(LocalPlayer)]()
+	{
+		if (WeakThis.IsValid() && WeakThis->CurrentPolicy && WeakLocalPlayer.IsValid())
+		{
+			WeakThis->CurrentPolicy->PrewarmPrimaryLayout(WeakLocalPlayer.Get());
+		}
+	});
+}
+
 void UGameplayCommonUISubsystem::NotifyPlayerAdded(ULocalPlayer* LocalPlayer)
 {
+	if (LocalPlayer && !LoginPreloadWidgetsHandle.IsValid())
+	{
+		LoginPreloadWidgetsHandle = LoadResidentWidgetClasses(EGameplayWidgetResidency::PreloadAtLogin);
+	}
+	
+	// Dialogs tend to be needed at the worst moments (disconnects, travel failures), so never leave them to a load on first use.
+	if (LocalPlayer && !DialogClassesHandle.IsValid() && UAssetManager::IsInitialized())
+	{
+		const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
+		
+		TArray<FSoftObjectPath> DialogPaths;
+		if (!Settings->ConfirmationDialogClass.IsNull())
+		{
+			DialogPaths.AddUnique(Settings->ConfirmationDialogClass.ToSoftObjectPath());
+		}
+		if (!Settings->ErrorDialogClass.IsNull())
+		{
+			DialogPaths.AddUnique(Settings->ErrorDialogClass.ToSoftObjectPath());
+		}
+		
+		if (!DialogPaths.IsEmpty())
+		{
+			constexpr bool bManageActiveHandle = false;
+			DialogClassesHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(MoveTemp(DialogPaths), FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority, bManageActiveHandle);
+		}
+	}
+	
 	if (ensure(LocalPlayer) && CurrentPolicy)
 	{
 		CurrentPolicy->NotifyPlayerAdded(LocalPlayer);
 	}
+	else if (LocalPlayer && IsLoadingUIPolicy())
+	{
+		PendingPlayersAdded.AddUnique(LocalPlayer);
+	}
 }
 
 void UGameplayCommonUISubsystem::NotifyPlayerRemoved(ULocalPlayer* LocalPlayer)
 {
+	PendingPlayersAdded.Remove(LocalPlayer);
+	
 	if (ensure(LocalPlayer) && CurrentPolicy)
 	{
 		CurrentPolicy->NotifyPlayerRemoved(LocalPlayer);
@@ -177,6 +324,8 @@ void UGameplayCommonUISubsystem::NotifyPlayerRemoved(ULocalPlayer* LocalPlayer)
 
 void UGameplayCommonUISubsystem::NotifyPlayerDestroyed(ULocalPlayer* LocalPlayer)
 {
+	PendingPlayersAdded.Remove(LocalPlayer);
+	
 	if (ensure(LocalPlayer) && CurrentPolicy)
 	{
 		CurrentPolicy->NotifyPlayerDestroyed(LocalPlayer);
@@ -191,6 +340,162 @@ void UGameplayCommonUISubsystem::NotifyButtonDescriptionTextChanged(UGameplayBut
 	}
 }
 
+void UGameplayCommonUISubsystem::CallOrQueueUntilPolicyReady(TFunction<void()>&& Request, TFunction<void()>&& OnCanceled)
+{
+	if (IsLoadingUIPolicy())
+	{
+		PendingPolicyRequests.Add({ MoveTemp(Request), MoveTemp(OnCanceled) });
+	}
+	else
+	{
+		Request();
+	}
+}
+
+void UGameplayCommonUISubsystem::HandleUIPolicyClassLoaded()
+{
+	UIPolicyLoadHandle.Reset();
+	
+	const UGameplayCommonUISettings* Settings = GetDefault<UGameplayCommonUISettings>();
+	const TSubclassOf<UGameplayCommonUIPolicy> PolicyClass = Settings->GameplayUIPolicyClass.Get();
+	if (ensure(PolicyClass) && !CurrentPolicy)
+	{
+		SwitchToPolicy(NewObject<UGameplayCommonUIPolicy>(this, PolicyClass));
+	}
+	
+	// Players first, so queued requests find their layouts.
+	TArray<TWeakObjectPtr<ULocalPlayer>> PlayersToAdd = MoveTemp(PendingPlayersAdded);
+	for (const TWeakObjectPtr<ULocalPlayer>& LocalPlayer : PlayersToAdd)
+	{
+		if (LocalPlayer.IsValid())
+		{
+			NotifyPlayerAdded(LocalPlayer.Get());
+		}
+	}
+	
+	if (CurrentPolicy)
+	{
+		OnUIPolicyReady.Broadcast(CurrentPolicy);
+	}
+	
+	TArray<FPendingPolicyRequest> Requests = MoveTemp(PendingPolicyRequests);
+	for (FPendingPolicyRequest& PendingRequest : Requests)
+	{
+		PendingRequest.Request();
+	}
+}
+
+void UGameplayCommonUISubsystem::RequestSharedClassLoad(const FSoftObjectPath& ClassPath, FStreamableDelegate OnLoaded)
+{
+	if (ClassPath.IsNull() || !UAssetManager::IsInitialized())
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+	
+	if (FSharedClassLoad* SharedLoad = SharedClassLoads.Find(ClassPath))
+	{
+		SharedLoad->LastRequestTime = FPlatformTime::Seconds();
+		if (SharedLoad->bLoaded)
+		{
+			OnLoaded.ExecuteIfBound();
+		}
+		else
+		{
+			SharedLoad->PendingCallbacks.Add(MoveTemp(OnLoaded));
+		}
+		return;
+	}
+	
+	// Register the callback first, the streamable manager may complete the load from inside the request.
+	FSharedClassLoad& NewLoad = SharedClassLoads.Add(ClassPath);
+	NewLoad.LastRequestTime = FPlatformTime::Seconds();
+	NewLoad.PendingCallbacks.Add(MoveTemp(OnLoaded));
+	
+	constexpr bool bManageActiveHandle = false;
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(ClassPath,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::HandleSharedClassLoaded, ClassPath), FStreamableManager::AsyncLoadHighPriority, bManageActiveHandle);
+	
+	if (FSharedClassLoad* SharedLoad = SharedClassLoads.Find(ClassPath))
+	{
+		SharedLoad->Handle = Handle;
+		if (!Handle.IsValid())
+		{
+			HandleSharedClassLoaded(ClassPath);
+		}
+	}
+	
+	if (!SweepSharedClassLoadsHandle.IsValid())
+	{
+		constexpr float SweepInterval = 1.0f;
+		SweepSharedClassLoadsHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::SweepSharedClassLoads), SweepInterval);
+	}
+}
+
+void UGameplayCommonUISubsystem::HandleSharedClassLoaded(FSoftObjectPath ClassPath)
+{
+	FSharedClassLoad* SharedLoad = SharedClassLoads.Find(ClassPath);
+	if (!SharedLoad || SharedLoad->bLoaded)
+	{
+		return;
+	}
+	
+	SharedLoad->bLoaded = true;
+	SharedLoad->LastRequestTime = FPlatformTime::Seconds();
+	
+	// Callbacks may request more loads and reallocate the map, so move them out first.
+	TArray<FStreamableDelegate> Callbacks = MoveTemp(SharedLoad->PendingCallbacks);
+	for (FStreamableDelegate& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound();
+	}
+}
+
+bool UGameplayCommonUISubsystem::SweepSharedClassLoads(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_UGameplayCommonUISubsystem_SweepSharedClassLoads);
+	
+	const double GracePeriod = GetDefault<UGameplayCommonUISettings>()->SharedLoadGracePeriod;
+	const double Now = FPlatformTime::Seconds();
+	
+	for (auto It = SharedClassLoads.CreateIterator(); It; ++It)
+	{
+		FSharedClassLoad& SharedLoad = It.Value();
+		if (SharedLoad.bLoaded && Now - SharedLoad.LastRequestTime > GracePeriod)
+		{
+			if (SharedLoad.Handle.IsValid())
+			{
+				SharedLoad.Handle->ReleaseHandle();
+			}
+			It.RemoveCurrent();
+		}
+	}
+	
+	if (SharedClassLoads.IsEmpty())
+	{
+		SweepSharedClassLoadsHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void UGameplayCommonUISubsystem::RecordWidgetPushTiming(const FGameplayWidgetPushTiming& PushTiming)
+{
+	constexpr int32 MaxPushHistoryPerLayer = 32;
+	
+	TArray<FGameplayWidgetPushTiming>& LayerHistory = WidgetPushHistory.FindOrAdd(PushTiming.LayerTag);
+	if (LayerHistory.Num() >= MaxPushHistoryPerLayer)
+	{
+		LayerHistory.RemoveAt(0, LayerHistory.Num() - MaxPushHistoryPerLayer + 1, EAllowShrinking::No);
+	}
+	LayerHistory.Add(PushTiming);
+}
+
+TArray<FGameplayWidgetPushTiming> UGameplayCommonUISubsystem::GetWidgetPushHistory(FGameplayTag LayerTag) const
+{
+	return WidgetPushHistory.FindRef(LayerTag);
+}
+
 void UGameplayCommonUISubsystem::SwitchToPolicy(UGameplayCommonUIPolicy* NewPolicy)
 {
 	if (CurrentPolicy != NewPolicy)
@@ -0,0 +1,264 @@
+﻿// Copyright Spike Plugins 2026. All Rights Reserved.
+
+#include "Tests/GameplayExtensionTestData.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Algo/AllOf.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+#include "GameplayTagsManager.h"
+#include "NativeGameplayTags.h"
+#include "Subsystems/GameplayCommonExtensionSubsystem.h"
+
+namespace GameplayExtensionTests
+{
+	// Dedicated tag tree, so nothing outside the test can ever match the registered points or extensions.
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Root, "GameplayCommonUI.Test.Extension")
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_A, "GameplayCommonUI.Test.Extension.A")
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_A_One, "GameplayCommonUI.Test.Extension.A.One")
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_A_Two, "GameplayCommonUI.Test.Extension.A.Two")
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_B, "GameplayCommonUI.Test.Extension.B")
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_B_One, "GameplayCommonUI.Test.Extension.B.One")
+	
+	static TAutoConsoleVariable<FString> CVarCustomBenchmark(
+		TEXT("GameplayCommonUI.Extensions.BenchmarkParams"),
+		TEXT(""),
+		TEXT("Parameters of the Custom variant of the extension benchmark, e.g. \"Points=500 Extensions=5000 Root=UI Depth=2 FanOut=4\". The variant is only listed when set."));
+	
+	/** One point in four listens to its whole subtree */
+	static bool IsPartialMatchPoint(int32 PointIndex) { return PointIndex % 4 == 0; }
+	
+	/** Size of a benchmark run and the tag hierarchy it spreads its points and extensions over */
+	struct FExtensionBenchmarkConfig
+	{
+		int32 NumPoints = 100;
+		int32 NumExtensions = 1000;
+		
+		/** Root of the hierarchy, any registered tag works. Defaults to the dedicated test tree */
+		FGameplayTag RootTag;
+		
+		/** Levels below the root that are used, and children used per tag */
+		int32 MaxDepth = MAX_int32;
+		int32 MaxFanOut = MAX_int32;
+		
+		/** Reads "Points=", "Extensions=", "Root=", "Depth=" and "FanOut=" from the test parameters */
+		static FExtensionBenchmarkConfig Parse(const FString& Parameters)
+		{
+			FExtensionBenchmarkConfig Config;
+			FParse::Value(*Parameters, TEXT("Points="), Config.NumPoints);
+			FParse::Value(*Parameters, TEXT("Extensions="), Config.NumExtensions);
+			FParse::Value(*Parameters, TEXT("Depth="), Config.MaxDepth);
+			FParse::Value(*Parameters, TEXT("FanOut="), Config.MaxFanOut);
+			
+			FString RootTagName;
+			Config.RootTag = TAG_Root;
+			if (FParse::Value(*Parameters, TEXT("Root="), RootTagName))
+			{
+				Config.RootTag = FGameplayTag::RequestGameplayTag(FName(*RootTagName), /*ErrorIfNotFound=*/false);
+			}
+			return Config;
+		}
+	};
+	
+	/** Collects the root and its descendants, parents before children, limited to the configured depth and fan-out */
+	static TArray<FGameplayTag> GatherBenchmarkTags(const FExtensionBenchmarkConfig& Config)
+	{
+		TArray<FGameplayTag> Tags;
+		TArray<TPair<TSharedPtr<FGameplayTagNode>, int32>> PendingNodes;
+		if (TSharedPtr<FGameplayTagNode> RootNode = UGameplayTagsManager::Get().FindTagNode(Config.RootTag))
+		{
+			PendingNodes.Emplace(RootNode, 0);
+		}
+		
+		// Breadth first with the children in the manager's order, so the distribution stays deterministic between runs.
+		for (int32 NodeIndex = 0; NodeIndex < PendingNodes.Num(); ++NodeIndex)
+		{
+			const TSharedPtr<FGameplayTagNode> Node = PendingNodes[NodeIndex].Key;
+			const int32 Depth = PendingNodes[NodeIndex].Value;
+			Tags.Add(Node->GetCompleteTag());
+			
+			if (Depth < Config.MaxDepth)
+			{
+				const TArray<TSharedPtr<FGameplayTagNode>>& ChildNodes = Node->GetChildTagNodes();
+				for (int32 ChildIndex = 0; ChildIndex < ChildNodes.Num() && ChildIndex < Config.MaxFanOut; ++ChildIndex)
+				{
+					PendingNodes.Emplace(ChildNodes[ChildIndex], Depth + 1);
+				}
+			}
+		}
+		return Tags;
+	}
+	
+	/**
+	 * Registers the configured extension points and extensions spread over the tag hierarchy, then unregisters 
+	 * everything. Checks the notifications of every phase against a brute force count and reports the time spent in each.
+	 */
+	static void RunExtensionBenchmark(FAutomationTestBase& Test, UGameplayCommonExtensionSubsystem& ExtensionSubsystem, const FExtensionBenchmarkConfig& Config, bool bBatched)
+	{
+		const int32 NumPoints = Config.NumPoints;
+		const int32 NumExtensions = Config.NumExtensions;
+		
+		const TArray<FGameplayTag> Tags = GatherBenchmarkTags(Config);
+		if (!Test.TestTrue(TEXT("The benchmark tag hierarchy has tags"), Tags.Num() > 0))
+		{
+			return;
+		}
+		Test.AddInfo(FString::Printf(TEXT("%d points, %d extensions over %d tags under [%s]"), NumPoints, NumExtensions, Tags.Num(), *Config.RootTag.ToString()));
+
+		// Expected deliveries per extension tag: exact points on the tag, plus partial points on the tag or any parent.
+		TArray<int32> NumReceiversByTag;
+		NumReceiversByTag.SetNumZeroed(Tags.Num());
+		for (int32 TagIndex = 0; TagIndex < Tags.Num(); ++TagIndex)
+		{
+			for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+			{
+				const FGameplayTag& PointTag = Tags[PointIndex % Tags.Num()];
+				if (Tags[TagIndex] == PointTag || (IsPartialMatchPoint(PointIndex) && Tags[TagIndex].MatchesTag(PointTag)))
+				{
+					++NumReceiversByTag[TagIndex];
+				}
+			}
+		}
+		
+		int32 ExpectedNotifications = 0;
+		for (int32 ExtensionIndex = 0; ExtensionIndex < NumExtensions; ++ExtensionIndex)
+		{
+			ExpectedNotifications += NumReceiversByTag[ExtensionIndex % Tags.Num()];
+		}
+
+		int32 NumAdded = 0;
+		int32 NumRemoved = 0;
+		const TArray<UClass*> AllowedDataClasses = { UGameplayExtensionTestData::StaticClass() };
+		const FGameplayExtendUIExtensionPointSignature Callback = FGameplayExtendUIExtensionPointSignature::CreateLambda([&NumAdded, &NumRemoved](EGameplayUIExtensionAction Action, const FGameplayUIExtensionRequest&)
+		{
+			if (Action == EGameplayUIExtensionAction::Added)
+			{
+				++NumAdded;
+			}
+			else
+			{
+				++NumRemoved;
+			}
+		});
+
+		const FString RunName = bBatched ? TEXT("Batched") : TEXT("Unbatched");
+		auto CheckPhase = [&](const TCHAR* PhaseName, double StartTime, int32 NumOperations, int32 ExpectedAdded, int32 ExpectedRemoved)
+		{
+			const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			Test.AddInfo(FString::Printf(TEXT("%s %-24s %10.3f ms  %8.3f us/op"), *RunName, PhaseName, ElapsedMs, NumOperations > 0 ? ElapsedMs * 1000.0 / NumOperations : 0.0));
+			
+			Test.TestEqual(FString::Printf(TEXT("%s %s: added notifications"), *RunName, PhaseName), NumAdded, ExpectedAdded);
+			Test.TestEqual(FString::Printf(TEXT("%s %s: removed notifications"), *RunName, PhaseName), NumRemoved, ExpectedRemoved);
+			NumAdded = 0;
+			NumRemoved = 0;
+		};
+
+		TArray<FGameplayUIExtensionPointHandle> PointHandles;
+		TArray<FGameplayUIExtensionHandle> ExtensionHandles;
+		PointHandles.Reserve(NumPoints + 1);
+		ExtensionHandles.Reserve(NumExtensions);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+		{
+			const EGameplayUIExtensionPointMatch MatchType = IsPartialMatchPoint(PointIndex) ? EGameplayUIExtensionPointMatch::PartialMatch : EGameplayUIExtensionPointMatch::ExactMatch;
+			PointHandles.Add(ExtensionSubsystem.RegisterExtensionPointInternal(Tags[PointIndex % Tags.Num()], MatchType, AllowedDataClasses, Callback));
+		}
+		CheckPhase(TEXT("Register points"), StartTime, NumPoints, 0, 0);
+		Test.TestTrue(TEXT("Every point handle is valid"), Algo::AllOf(PointHandles, [](const FGameplayUIExtensionPointHandle& Handle) { return Handle.IsValid(); }));
+
+		StartTime = FPlatformTime::Seconds();
+		{
+			TOptional<FGameplayUIExtensionBatchScope> BatchScope;
+			if (bBatched)
+			{
+				BatchScope.Emplace(&ExtensionSubsystem);
+			}
+			
+			for (int32 ExtensionIndex = 0; ExtensionIndex < NumExtensions; ++ExtensionIndex)
+			{
+				ExtensionHandles.Add(ExtensionSubsystem.RegisterExtensionAsDataInternal(Tags[ExtensionIndex % Tags.Num()], nullptr, UGameplayExtensionTestData::StaticClass(), ExtensionIndex % 8));
+			}
+			
+			if (bBatched)
+			{
+				Test.TestEqual(TEXT("Batched registrations are not delivered before the batch closes"), NumAdded, 0);
+			}
+		}
+		CheckPhase(TEXT("Register extensions"), StartTime, NumExtensions, ExpectedNotifications, 0);
+
+		// A partial point registered late on the root receives every existing extension.
+		StartTime = FPlatformTime::Seconds();
+		PointHandles.Add(ExtensionSubsystem.RegisterExtensionPointInternal(Config.RootTag, EGameplayUIExtensionPointMatch::PartialMatch, AllowedDataClasses, Callback));
+		CheckPhase(TEXT("Register late point"), StartTime, 1, NumExtensions, 0);
+
+		StartTime = FPlatformTime::Seconds();
+		for (FGameplayUIExtensionHandle& Handle : ExtensionHandles)
+		{
+			Handle.Unregister();
+		}
+		CheckPhase(TEXT("Unregister extensions"), StartTime, NumExtensions, 0, ExpectedNotifications + NumExtensions);
+
+		StartTime = FPlatformTime::Seconds();
+		for (FGameplayUIExtensionPointHandle& Handle : PointHandles)
+		{
+			Handle.Unregister();
+		}
+		CheckPhase(TEXT("Unregister points"), StartTime, PointHandles.Num(), 0, 0);
+		
+		// Nothing registered anymore, a new extension must not reach any of the old points.
+		FGameplayUIExtensionHandle StrayHandle = ExtensionSubsystem.RegisterExtensionAsDataInternal(Tags.Last(), nullptr, UGameplayExtensionTestData::StaticClass(), 0);
+		StrayHandle.Unregister();
+		CheckPhase(TEXT("Register after teardown"), FPlatformTime::Seconds(), 1, 0, 0);
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FGameplayExtensionSubsystemBenchmarkTest, "GameplayCommonUI.Extensions.Benchmark", 
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FGameplayExtensionSubsystemBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add(TEXT("Small"));
+	OutTestCommands.Add(TEXT("Points=100 Extensions=1000"));
+	
+	OutBeautifiedNames.Add(TEXT("Large"));
+	OutTestCommands.Add(TEXT("Points=1000 Extensions=10000"));
+	
+	OutBeautifiedNames.Add(TEXT("Shallow"));
+	OutTestCommands.Add(TEXT("Points=1000 Extensions=10000 Depth=1"));
+	
+	const FString CustomParameters = GameplayExtensionTests::CVarCustomBenchmark.GetValueOnAnyThread();
+	if (!CustomParameters.IsEmpty())
+	{
+		OutBeautifiedNames.Add(TEXT("Custom"));
+		OutTestCommands.Add(CustomParameters);
+	}
+}
+
+bool FGameplayExtensionSubsystemBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const GameplayExtensionTests::FExtensionBenchmarkConfig Config = GameplayExtensionTests::FExtensionBenchmarkConfig::Parse(Parameters);
+	
+
+	// An isolated world owns its own extension subsystem, the points of any running game never see the test data.
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld=*/false);
+	UGameplayCommonExtensionSubsystem* ExtensionSubsystem = World ? World->GetSubsystem<UGameplayCommonExtensionSubsystem>() : nullptr;
+	
+	if (TestNotNull(TEXT("Extension subsystem of the test world"), ExtensionSubsystem))
+	{
+		GameplayExtensionTests::RunExtensionBenchmark(*this, *ExtensionSubsystem, Config, /*bBatched=*/false);
+		GameplayExtensionTests::RunExtensionBenchmark(*this, *ExtensionSubsystem, Config, /*bBatched=*/true);
+	}
+	
+	if (World)
+	{
+		World->DestroyWorld(/*bInformEngineOfWorld=*/false);
+	}
+	
+	return !HasAnyErrors();
+}
+
+#endif
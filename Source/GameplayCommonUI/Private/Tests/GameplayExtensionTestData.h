@@ -0,0 +1,14 @@
+﻿// Copyright Spike Plugins 2026. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "GameplayExtensionTestData.generated.h"
+
+/** @brief Concrete data payload registered by the extension subsystem automation tests */
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UGameplayExtensionTestData : public UObject
+{
+	GENERATED_BODY()
+};
@@ -1,7 +1,9 @@
 ﻿// Copyright Spike Plugins 2026. All Rights Reserved.
 
 #include "Widgets/GameplayExtensionPoint.h"
+#include "Algo/BinarySearch.h"
 #include "GameFramework/PlayerState.h"
+#include "Misc/GameplayCommonStats.h"
 #include "Misc/UObjectToken.h"
 #include "Subsystems/GameplayCommonLocalPlayerSubsystem.h"
 
@@ -45,9 +47,16 @@ TSharedRef<SWidget> UGameplayExtensionPoint::RebuildWidget()
 	if (!IsDesignTime() && ExtensionPointTag.IsValid())
 	{
 		ResetExtensionPoint();
+		
+		if (!bEntryPoolPrewarmed)
+		{
+			PrewarmEntryPool();
+		}
+		
 		RegisterExtensionPoint();
 		
-		if (UGameplayCommonLocalPlayerSubsystem* UILocalPlayerSubsystem = GetOwningLocalPlayer()->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>())
+		const ULocalPlayer* LocalPlayer = GetOwningLocalPlayer();
+		if (UGameplayCommonLocalPlayerSubsystem* UILocalPlayerSubsystem = LocalPlayer ? LocalPlayer->GetSubsystem<UGameplayCommonLocalPlayerSubsystem>() : nullptr)
 		{
 			UILocalPlayerSubsystem->OnLocalPlayerStateSet.AddUObject(this, &ThisClass::RegisterExtensionPointForPlayerState);
 		}
@@ -78,8 +87,35 @@ TSharedRef<SWidget> UGameplayExtensionPoint::RebuildWidget()
 	return Super::RebuildWidget();
 }
 
+void UGameplayExtensionPoint::PrewarmEntryPool()
+{
+	bEntryPoolPrewarmed = true;
+
+	// Create every instance before releasing any, otherwise the pool would hand back the same widget each time.
+	TArray<UUserWidget*> PrewarmedEntries;
+	for (const TPair<TSubclassOf<UUserWidget>, int32>& PrewarmPair : PrewarmedEntryClasses)
+	{
+		if (PrewarmPair.Key)
+		{
+			for (int32 Index = 0; Index < PrewarmPair.Value; ++Index)
+			{
+				if (UUserWidget* Entry = CreateEntryInternal(PrewarmPair.Key))
+				{
+					PrewarmedEntries.Add(Entry);
+				}
+			}
+		}
+	}
+
+	for (UUserWidget* Entry : PrewarmedEntries)
+	{
+		RemoveEntryInternal(Entry);
+	}
+}
+
 void UGameplayExtensionPoint::ResetExtensionPoint()
 {
+	ClearPendingExtensions();
 	ResetInternal();
 
 	ExtensionMapping.Reset();
@@ -137,40 +173,126 @@ void UGameplayExtensionPoint::OnAddOrRemoveExtension(EGameplayUIExtensionAction
 {
 	if (Action == EGameplayUIExtensionAction::Added)
 	{
-		UObject* Data = Request.Data;
-		
-		TSubclassOf<UUserWidget> WidgetClass(Cast<UClass>(Data));
-		if (WidgetClass)
+		if (bDeferWidgetCreation)
 		{
-			UUserWidget* Widget = CreateEntryInternal(WidgetClass);
-			ExtensionMapping.Add(Request.ExtensionHandle, Widget);
+			// Higher priorities are built first, equal priorities keep their arrival order.
+			// Only the part of the queue not yet dequeued by a running tick is searched.
+			const TArrayView<const FGameplayUIExtensionRequest> QueuedRequests = MakeArrayView(PendingExtensionRequests).Mid(PendingExtensionsHead);
+			const int32 InsertIndex = PendingExtensionsHead + Algo::UpperBoundBy(QueuedRequests, Request.Priority, &FGameplayUIExtensionRequest::Priority, TGreater<>());
+			PendingExtensionRequests.Insert(Request, InsertIndex);
+			
+			if (!ProcessPendingExtensionsHandle.IsValid())
+			{
+				ProcessPendingExtensionsHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::ProcessPendingExtensions));
+			}
 		}
-		else if (DataClasses.Num() > 0)
+		else
+		{
+			CreateExtensionWidget(Request);
+		}
+	}
+	else
+	{
+		// An extension removed before its widget was built only needs to leave the queue.
+		for (int32 PendingIndex = PendingExtensionsHead; PendingIndex < PendingExtensionRequests.Num(); ++PendingIndex)
 		{
-			if (GetWidgetClassForData.IsBound())
+			if (PendingExtensionRequests[PendingIndex].ExtensionHandle == Request.ExtensionHandle)
 			{
-				WidgetClass = GetWidgetClassForData.Execute(Data);
+				PendingExtensionRequests.RemoveAt(PendingIndex, EAllowShrinking::No);
+				return;
+			}
+		}
+		
+		if (UUserWidget* Extension = ExtensionMapping.FindRef(Request.ExtensionHandle))
+		{
+			// The entry goes back to the entry pool and is recycled by the next extension of the same class.
+			RemoveEntryInternal(Extension);
+			ExtensionMapping.Remove(Request.ExtensionHandle);
+		}
+	}
+}
 
-				// If the data is irrelevant they can just return no widget class.
-				if (WidgetClass)
+void UGameplayExtensionPoint::CreateExtensionWidget(const FGameplayUIExtensionRequest& Request)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameplayUI_CreateExtensionWidget);
+	CSV_SCOPED_TIMING_STAT(GameplayCommonUI, CreateExtensionWidget);
+	
+	UObject* Data = Request.Data;
+		
+	TSubclassOf<UUserWidget> WidgetClass(Cast<UClass>(Data));
+	if (WidgetClass)
+	{
+		UUserWidget* Widget = CreateEntryInternal(WidgetClass);
+		ExtensionMapping.Add(Request.ExtensionHandle, Widget);
+		
+		INC_DWORD_STAT(STAT_GameplayUI_ExtensionWidgetsCreated);
+		CSV_CUSTOM_STAT(GameplayCommonUI, ExtensionWidgetsCreated, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else if (DataClasses.Num() > 0)
+	{
+		if (GetWidgetClassForData.IsBound())
+		{
+			WidgetClass = GetWidgetClassForData.Execute(Data);
+
+			// If the data is irrelevant they can just return no widget class.
+			if (WidgetClass)
+			{
+				if (UUserWidget* Widget = CreateEntryInternal(WidgetClass))
 				{
-					if (UUserWidget* Widget = CreateEntryInternal(WidgetClass))
-					{
-						ExtensionMapping.Add(Request.ExtensionHandle, Widget);
-						ConfigureWidgetForData.ExecuteIfBound(Widget, Data);
-					}
+					ExtensionMapping.Add(Request.ExtensionHandle, Widget);
+					ConfigureWidgetForData.ExecuteIfBound(Widget, Data);
+					
+					INC_DWORD_STAT(STAT_GameplayUI_ExtensionWidgetsCreated);
+					CSV_CUSTOM_STAT(GameplayCommonUI, ExtensionWidgetsCreated, 1, ECsvCustomStatOp::Accumulate);
 				}
 			}
 		}
 	}
-	else
+}
+
+bool UGameplayExtensionPoint::ProcessPendingExtensions(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_UGameplayExtensionPoint_ProcessPendingExtensions);
+	
+	const double BudgetEndTime = FPlatformTime::Seconds() + WidgetCreationBudgetMs / 1000.0;
+
+	// Always make progress, even when a single widget costs more than the whole budget.
+	// The request is dequeued before creation, configuring the widget may add or remove other extensions.
+	// Dequeuing only advances the head, the processed requests are removed in one go once the budget is spent.
+	while (PendingExtensionsHead < PendingExtensionRequests.Num())
 	{
-		if (UUserWidget* Extension = ExtensionMapping.FindRef(Request.ExtensionHandle))
+		const FGameplayUIExtensionRequest Request = PendingExtensionRequests[PendingExtensionsHead++];
+		
+		CreateExtensionWidget(Request);
+
+		if (FPlatformTime::Seconds() >= BudgetEndTime)
 		{
-			RemoveEntryInternal(Extension);
-			ExtensionMapping.Remove(Request.ExtensionHandle);
+			break;
 		}
 	}
+	
+	PendingExtensionRequests.RemoveAt(0, PendingExtensionsHead, EAllowShrinking::No);
+	PendingExtensionsHead = 0;
+	
+	if (PendingExtensionRequests.IsEmpty())
+	{
+		ProcessPendingExtensionsHandle.Reset();
+		return false;
+	}
+	
+	return true;
+}
+
+void UGameplayExtensionPoint::ClearPendingExtensions()
+{
+	PendingExtensionRequests.Reset();
+	PendingExtensionsHead = 0;
+	
+	if (ProcessPendingExtensionsHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(ProcessPendingExtensionsHandle);
+		ProcessPendingExtensionsHandle.Reset();
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
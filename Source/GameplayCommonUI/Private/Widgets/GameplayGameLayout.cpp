@@ -97,8 +97,10 @@ bool UGameplayGameLayout::ShouldPlatformDisplayControllerDisconnectScreen() cons
 	
 	// Check the tags that we may be emulating in the editor too
 #if WITH_EDITOR
-	const FGameplayTagContainer& PlatformEmulationTags = UCommonUIVisibilitySubsystem::Get(GetOwningLocalPlayer())->GetVisibilityTags();
-	bHasAllRequiredTags |= PlatformEmulationTags.HasAll(PlatformRequiresControllerDisconnectScreen);
+	if (const UCommonUIVisibilitySubsystem* VisibilitySubsystem = UCommonUIVisibilitySubsystem::Get(GetOwningLocalPlayer()))
+	{
+		bHasAllRequiredTags |= VisibilitySubsystem->GetVisibilityTags().HasAll(PlatformRequiresControllerDisconnectScreen);
+	}
 #endif
 	
 	return bHasAllRequiredTags;
@@ -9,9 +9,31 @@
 #include "Widgets/CommonActivatableWidgetContainer.h"
 #include "GameFramework/PlayerController.h"
 #include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/GameplayCommonStats.h"
+#include "UObject/UObjectIterator.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
 
 DEFINE_LOG_CATEGORY(LogGameplayPrimaryLayout);
 
+static TAutoConsoleVariable<float> CVarLayerTransitionScale(
+	TEXT("GameplayCommonUI.LayerTransitionScale"),
+	1.0f,
+	TEXT("Scales the transition duration of every primary layout layer. 0 makes all layer transitions instant."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+	{
+		for (TObjectIterator<UGameplayPrimaryLayout> It; It; ++It)
+		{
+			if (!It->IsTemplate())
+			{
+				It->RefreshLayerTransitions();
+			}
+		}
+	}),
+	ECVF_Scalability
+);
+
 UGameplayPrimaryLayout::UGameplayPrimaryLayout(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -23,6 +45,28 @@ void UGameplayPrimaryLayout::NativeOnInitialized()
 	Super::NativeOnInitialized();
 }
 
+void UGameplayPrimaryLayout::NativeDestruct()
+{
+	if (WindowRenderedHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+		{
+			Renderer->OnSlateWindowRendered().Remove(WindowRenderedHandle);
+		}
+	}
+	WindowRenderedHandle.Reset();
+	InFlightPushTimings.Reset();
+	
+	// Layers torn down mid-transition never report the end, give the player its input back.
+	for (const TPair<TObjectKey<UCommonActivatableWidgetContainerBase>, FActiveLayerTransition>& Transition : ActiveLayerTransitions)
+	{
+		UGameplayCommonUILibrary::ResumeInputForPlayer(GetOwningLocalPlayer(), Transition.Value.SuspendInputToken);
+	}
+	ActiveLayerTransitions.Reset();
+	
+	Super::NativeDestruct();
+}
+
 UGameplayPrimaryLayout* UGameplayPrimaryLayout::GetPrimaryGameLayoutForPrimaryPlayer(const UObject* WorldContextObject)
 {
 	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
@@ -37,33 +81,7 @@ UGameplayPrimaryLayout* UGameplayPrimaryLayout::GetPrimaryGameLayout(const APlay
 
 UGameplayPrimaryLayout* UGameplayPrimaryLayout::GetPrimaryGameLayout(const ULocalPlayer* LocalPlayer)
 {
-	if (!LocalPlayer) return nullptr;
-	
-	const UGameInstance* GameInstance = LocalPlayer->GetGameInstance();
-	if (!GameInstance)
-	{
-		return nullptr;
-	}
-
-	const UGameplayCommonUISubsystem* UIManager = GameInstance->GetSubsystem<UGameplayCommonUISubsystem>();
-	if (!UIManager)
-	{
-		return nullptr;
-	}
-
-	const UGameplayCommonUIPolicy* Policy = UIManager->GetUIPolicy();
-	if (!Policy)
-	{
-		return nullptr;
-	}
-
-	UGameplayPrimaryLayout* PrimaryLayout = Policy->GetPrimaryLayoutFromLocalPlayer(LocalPlayer);
-	if (!PrimaryLayout)
-	{
-		return nullptr;
-	}
-
-	return PrimaryLayout;
+	return UGameplayCommonUILibrary::ResolvePrimaryLayout(LocalPlayer);
 }
 
 void UGameplayPrimaryLayout::SetIsDormant(bool bInIsDormant)
@@ -86,9 +104,45 @@ void UGameplayPrimaryLayout::OnIsDormantChanged()
 {
 }
 
+void UGameplayPrimaryLayout::NotifyPawnChanged(APawn* NewPawn)
+{
+	if (BoundPawn.Get() != NewPawn)
+	{
+		BoundPawn = NewPawn;
+		NativeOnPawnChanged(NewPawn);
+	}
+}
+
+void UGameplayPrimaryLayout::NativeOnPawnChanged(APawn* NewPawn)
+{
+	BP_OnPawnChanged(NewPawn);
+}
+
 void UGameplayPrimaryLayout::FindAndRemoveWidgetFromLayer(UCommonActivatableWidget* ActivatableWidget)
 {
-	// We're not sure what layer the widget is on, so go searching.
+	if (!ActivatableWidget)
+	{
+		return;
+	}
+	
+	const FGameplayTag LayerTag = WidgetLayers.FindRef(ActivatableWidget);
+	if (LayerTag.IsValid())
+	{
+		// Removing it first lets its deactivation reach the retention policy of the layer.
+		UCommonActivatableWidgetContainerBase* Layer = RegisteredLayers.FindRef(LayerTag);
+		if (Layer)
+		{
+			Layer->RemoveWidget(*ActivatableWidget);
+		}
+		
+		ForgetWidgetLayer(ActivatableWidget);
+		if (Layer)
+		{
+			return;
+		}
+	}
+	
+	// The widget was added to a layer without going through this layout, so go searching.
 	for (const auto& LayerKVP : RegisteredLayers)
 	{
 		LayerKVP.Value->RemoveWidget(*ActivatableWidget);
@@ -97,12 +151,19 @@ void UGameplayPrimaryLayout::FindAndRemoveWidgetFromLayer(UCommonActivatableWidg
 
 void UGameplayPrimaryLayout::FindAndRemoveWidgetsFromLayer(FGameplayTag LayerTag)
 {
-	for (const auto& LayerKVP : RegisteredLayers)
+	if (UCommonActivatableWidgetContainerBase* Layer = RegisteredLayers.FindRef(LayerTag))
 	{
-		if (LayerKVP.Key.MatchesTagExact(LayerTag))
+		Layer->ClearWidgets();
+		
+		TSet<TObjectKey<UCommonActivatableWidget>> RemovedWidgets;
+		if (LayerWidgets.RemoveAndCopyValue(LayerTag, RemovedWidgets))
 		{
-			LayerKVP.Value->ClearWidgets();
+			for (const TObjectKey<UCommonActivatableWidget>& WidgetKey : RemovedWidgets)
+			{
+				ForgetWidgetLayer(WidgetKey);
+			}
 		}
+		DeactivatedLayerWidgets.Remove(LayerTag);
 	}
 }
 
@@ -112,6 +173,232 @@ void UGameplayPrimaryLayout::ClearAllLayerStacks()
 	{
 		KVP.Value->ClearWidgets();
 	}
+	
+	for (const TPair<TObjectKey<UCommonActivatableWidget>, FGameplayTag>& WidgetLayer : WidgetLayers)
+	{
+		if (UCommonActivatableWidget* Widget = WidgetLayer.Key.ResolveObjectPtr())
+		{
+			Widget->OnDeactivated().RemoveAll(this);
+		}
+	}
+	WidgetLayers.Reset();
+	LayerWidgets.Reset();
+	DeactivatedLayerWidgets.Reset();
+}
+
+FGameplayWidgetPushTiming UGameplayPrimaryLayout::BeginWidgetPushTiming(const FGameplayTag& LayerTag, const UClass* WidgetClass)
+{
+	FGameplayWidgetPushTiming PushTiming;
+	if (PendingPushTiming.IsSet())
+	{
+		PushTiming = PendingPushTiming.GetValue();
+		PendingPushTiming.Reset();
+	}
+	else
+	{
+		PushTiming.RequestTime = FPlatformTime::Seconds();
+		PushTiming.LoadedMs = 0.0f;
+	}
+	
+	PushTiming.LayerTag = LayerTag;
+	PushTiming.WidgetClassName = WidgetClass ? WidgetClass->GetFName() : NAME_None;
+	return PushTiming;
+}
+
+void UGameplayPrimaryLayout::TrackWidgetPushTiming(UCommonActivatableWidget* Widget, FGameplayWidgetPushTiming&& PushTiming)
+{
+	if (!Widget)
+	{
+		return;
+	}
+	
+	PushTiming.ConstructedMs = PushTiming.GetElapsedMs();
+	if (Widget->IsActivated())
+	{
+		PushTiming.ActivatedMs = PushTiming.ConstructedMs;
+	}
+	else
+	{
+		TWeakObjectPtr<UCommonActivatableWidget> WeakWidget = Widget;
+		Widget->OnActivated().AddWeakLambda(this, [this, WeakWidget]()
+		{
+			if (UCommonActivatableWidget* ActivatedWidget = WeakWidget.Get())
+			{
+				ActivatedWidget->OnActivated().RemoveAll(this);
+				
+				if (FGameplayWidgetPushTiming* InFlightTiming = InFlightPushTimings.Find(ActivatedWidget))
+				{
+					InFlightTiming->ActivatedMs = InFlightTiming->GetElapsedMs();
+					if (InFlightTiming->FirstPaintMs >= 0.0f)
+					{
+						FinishWidgetPushTiming(ActivatedWidget);
+					}
+				}
+			}
+		});
+	}
+	
+	InFlightPushTimings.Add(Widget, MoveTemp(PushTiming));
+	
+	if (!WindowRenderedHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+		{
+			WindowRenderedHandle = Renderer->OnSlateWindowRendered().AddUObject(this, &ThisClass::HandleWindowRendered);
+		}
+	}
+}
+
+void UGameplayPrimaryLayout::HandleWindowRendered(SWindow& Window, void* ViewportRHIPtr)
+{
+	TArray<const UCommonActivatableWidget*, TInlineAllocator<4>> FinishedWidgets;
+	for (auto It = InFlightPushTimings.CreateIterator(); It; ++It)
+	{
+		const UCommonActivatableWidget* Widget = It.Key().ResolveObjectPtr();
+		if (!Widget)
+		{
+			// Destroyed before it was ever shown, nothing meaningful to report.
+			It.RemoveCurrent();
+			continue;
+		}
+		
+		FGameplayWidgetPushTiming& PushTiming = It.Value();
+		if (PushTiming.FirstPaintMs < 0.0f)
+		{
+			PushTiming.FirstPaintMs = PushTiming.GetElapsedMs();
+		}
+		
+		// Widgets pushed below another one may never activate, so don't keep them waiting forever. The top of an animated 
+		// layer is still the previous widget until the transition ends, so it waits for its activation or the transition end.
+		const UCommonActivatableWidgetContainerBase* Layer = RegisteredLayers.FindRef(PushTiming.LayerTag);
+		const bool bPushedBelow = !Layer || Layer->GetWidgetList().IsEmpty() || Layer->GetWidgetList().Last() != Widget;
+		if (PushTiming.ActivatedMs >= 0.0f || bPushedBelow || !IsLayerTransitioning(PushTiming.LayerTag))
+		{
+			FinishedWidgets.Add(Widget);
+		}
+	}
+	
+	for (const UCommonActivatableWidget* Widget : FinishedWidgets)
+	{
+		FinishWidgetPushTiming(Widget);
+	}
+}
+
+void UGameplayPrimaryLayout::FinishWidgetPushTiming(const UCommonActivatableWidget* Widget)
+{
+	FGameplayWidgetPushTiming PushTiming;
+	if (!InFlightPushTimings.RemoveAndCopyValue(Widget, PushTiming))
+	{
+		return;
+	}
+	
+	CSV_CUSTOM_STAT(GameplayCommonUI, PushLoadedMs, PushTiming.LoadedMs, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(GameplayCommonUI, PushConstructedMs, PushTiming.ConstructedMs, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(GameplayCommonUI, PushFirstPaintMs, PushTiming.FirstPaintMs, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(GameplayCommonUI, PushActivatedMs, PushTiming.ActivatedMs, ECsvCustomStatOp::Max);
+	
+	UE_LOG(LogGameplayPrimaryLayout, Verbose, TEXT("Push of [%s] to [%s]: loaded %.2f ms, constructed %.2f ms, first paint %.2f ms, activated %.2f ms"),
+		*PushTiming.WidgetClassName.ToString(), *PushTiming.LayerTag.ToString(), PushTiming.LoadedMs, PushTiming.ConstructedMs, PushTiming.FirstPaintMs, PushTiming.ActivatedMs);
+	
+	if (const UGameInstance* GameInstance = GetGameInstance())
+	{
+		if (UGameplayCommonUISubsystem* UIManager = GameInstance->GetSubsystem<UGameplayCommonUISubsystem>())
+		{
+			UIManager->RecordWidgetPushTiming(PushTiming);
+		}
+	}
+	
+	if (InFlightPushTimings.IsEmpty() && WindowRenderedHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+		{
+			Renderer->OnSlateWindowRendered().Remove(WindowRenderedHandle);
+		}
+		WindowRenderedHandle.Reset();
+	}
+}
+
+void UGameplayPrimaryLayout::RecordWidgetLayer(UCommonActivatableWidget* Widget, const FGameplayTag& LayerTag)
+{
+	if (!Widget)
+	{
+		return;
+	}
+	
+	// A retained widget may come back, possibly to another layer, so drop whatever it was recorded with first.
+	ForgetWidgetLayer(Widget);
+	
+	WidgetLayers.Add(Widget, LayerTag);
+	LayerWidgets.FindOrAdd(LayerTag).Add(Widget);
+	Widget->OnDeactivated().AddUObject(this, &ThisClass::HandleLayerWidgetDeactivated, TWeakObjectPtr<UCommonActivatableWidget>(Widget));
+}
+
+void UGameplayPrimaryLayout::ForgetWidgetLayer(const TObjectKey<UCommonActivatableWidget>& WidgetKey)
+{
+	FGameplayTag LayerTag;
+	if (!WidgetLayers.RemoveAndCopyValue(WidgetKey, LayerTag))
+	{
+		return;
+	}
+	
+	if (TSet<TObjectKey<UCommonActivatableWidget>>* Widgets = LayerWidgets.Find(LayerTag))
+	{
+		Widgets->Remove(WidgetKey);
+	}
+	if (TSet<TObjectKey<UCommonActivatableWidget>>* Widgets = DeactivatedLayerWidgets.Find(LayerTag))
+	{
+		Widgets->Remove(WidgetKey);
+	}
+	
+	if (UCommonActivatableWidget* Widget = WidgetKey.ResolveObjectPtr())
+	{
+		Widget->OnDeactivated().RemoveAll(this);
+	}
+}
+
+void UGameplayPrimaryLayout::HandleLayerWidgetDeactivated(TWeakObjectPtr<UCommonActivatableWidget> WeakWidget)
+{
+	UCommonActivatableWidget* Widget = WeakWidget.Get();
+	const FGameplayTag LayerTag = WidgetLayers.FindRef(Widget);
+	if (!Widget || !LayerTag.IsValid())
+	{
+		return;
+	}
+	
+	HandleRetainedWidgetDeactivated(WeakWidget, LayerTag);
+	
+	// A popped widget usually stays in the layer until its transition has finished, the layer reports that with its 
+	// displayed widget change. If the layer has already let go of it, there is nothing to wait for.
+	const UCommonActivatableWidgetContainerBase* Layer = RegisteredLayers.FindRef(LayerTag);
+	if (!Layer || !Layer->GetWidgetList().Contains(Widget))
+	{
+		ForgetWidgetLayer(Widget);
+	}
+	else
+	{
+		DeactivatedLayerWidgets.FindOrAdd(LayerTag).Add(Widget);
+	}
+}
+
+void UGameplayPrimaryLayout::HandleLayerDisplayedWidgetChanged(UCommonActivatableWidget* DisplayedWidget, FGameplayTag LayerTag)
+{
+	TSet<TObjectKey<UCommonActivatableWidget>> DeactivatedWidgets;
+	if (!DeactivatedLayerWidgets.RemoveAndCopyValue(LayerTag, DeactivatedWidgets))
+	{
+		return;
+	}
+	
+	// The container releases popped widgets right before it reports the new displayed widget. Only the widgets that 
+	// deactivated since the last change can have left, the others are still covered.
+	const UCommonActivatableWidgetContainerBase* Layer = RegisteredLayers.FindRef(LayerTag);
+	for (const TObjectKey<UCommonActivatableWidget>& WidgetKey : DeactivatedWidgets)
+	{
+		const UCommonActivatableWidget* Widget = WidgetKey.ResolveObjectPtr();
+		if (!Widget || !Layer || !Layer->GetWidgetList().Contains(Widget))
+		{
+			ForgetWidgetLayer(WidgetKey);
+		}
+	}
 }
 
 UCommonActivatableWidgetContainerBase* UGameplayPrimaryLayout::GetLayerStackContainer(FGameplayTag LayerTag)
@@ -121,33 +408,207 @@ UCommonActivatableWidgetContainerBase* UGameplayPrimaryLayout::GetLayerStackCont
 
 FString UGameplayPrimaryLayout::GetLayerNameFromContainer(const UCommonActivatableWidgetContainerBase* Container) const
 {
-	for (const auto& LayerKVP : RegisteredLayers)
+	if (const FGameplayTag* LayerTag = LayerTagsByContainer.Find(Container))
 	{
-		if (LayerKVP.Value == Container)
-		{
-			return LayerKVP.Key.ToString();
-		}
+		return LayerTag->ToString();
 	}
 	return TEXT("UnknownLayer");
 }
 
 void UGameplayPrimaryLayout::OnWidgetStackTransitioning(UCommonActivatableWidgetContainerBase* Widget, bool bIsTransitioning)
 {
+	const FGameplayTag LayerTag = LayerTagsByContainer.FindRef(Widget);
+	
 	if (bIsTransitioning)
 	{
-		const FName SuspendToken = UGameplayCommonUILibrary::SuspendInputForPlayer(GetOwningLocalPlayer(), TEXT("GlobalStackTransition"));
-		SuspendInputTokens.Add(SuspendToken);
+		if (ActiveLayerTransitions.Contains(Widget))
+		{
+			return;
+		}
+		
+		FActiveLayerTransition& Transition = ActiveLayerTransitions.Add(Widget);
+		Transition.SuspendInputToken = UGameplayCommonUILibrary::SuspendInputForPlayer(GetOwningLocalPlayer(), TEXT("GlobalStackTransition"));
+		Transition.StartTime = FPlatformTime::Seconds();
+		
+		OnLayerTransitionChanged.Broadcast(LayerTag, true, 0.0);
 	}
 	else
 	{
-		if (ensure(SuspendInputTokens.Num() > 0))
+		// A container registered mid-transition reports the end without a start.
+		FActiveLayerTransition Transition;
+		if (ActiveLayerTransitions.RemoveAndCopyValue(Widget, Transition))
+		{
+			UGameplayCommonUILibrary::ResumeInputForPlayer(GetOwningLocalPlayer(), Transition.SuspendInputToken);
+			
+			const double TransitionSeconds = FPlatformTime::Seconds() - Transition.StartTime;
+			CSV_CUSTOM_STAT(GameplayCommonUI, LayerTransitionMs, TransitionSeconds * 1000.0, ECsvCustomStatOp::Max);
+			UE_LOG(LogGameplayPrimaryLayout, Verbose, TEXT("Layer [%s] finished transitioning in %.2f ms"), *LayerTag.ToString(), TransitionSeconds * 1000.0);
+			
+			OnLayerTransitionChanged.Broadcast(LayerTag, false, TransitionSeconds);
+		}
+	}
+}
+
+void UGameplayPrimaryLayout::SetLayerTransitionPolicy(FGameplayTag LayerTag, const FGameplayLayerTransitionPolicy& Policy)
+{
+	LayerTransitionPolicies.Add(LayerTag, Policy);
+	
+	if (UCommonActivatableWidgetContainerBase* Stack = RegisteredLayers.FindRef(LayerTag))
+	{
+		ApplyLayerTransitionPolicy(LayerTag, Stack);
+	}
+}
+
+void UGameplayPrimaryLayout::RefreshLayerTransitions()
+{
+	for (const auto& LayerKVP : RegisteredLayers)
+	{
+		ApplyLayerTransitionPolicy(LayerKVP.Key, LayerKVP.Value);
+	}
+}
+
+bool UGameplayPrimaryLayout::IsLayerTransitioning(FGameplayTag LayerTag) const
+{
+	const UCommonActivatableWidgetContainerBase* Stack = RegisteredLayers.FindRef(LayerTag);
+	return Stack && ActiveLayerTransitions.Contains(Stack);
+}
+
+void UGameplayPrimaryLayout::ApplyLayerTransitionPolicy(const FGameplayTag& LayerTag, UCommonActivatableWidgetContainerBase* Stack)
+{
+	if (!Stack)
+	{
+		return;
+	}
+	
+	const float AuthoredDuration = AuthoredTransitionDurations.FindRef(Stack);
+	const FGameplayLayerTransitionPolicy* Policy = LayerTransitionPolicies.Find(LayerTag);
+	
+	float Duration = AuthoredDuration;
+	switch (Policy ? Policy->Mode : EGameplayLayerTransitionMode::Default)
+	{
+	case EGameplayLayerTransitionMode::Default:
+		break;
+	case EGameplayLayerTransitionMode::Instant:
+		Duration = 0.0f;
+		break;
+	case EGameplayLayerTransitionMode::Animated:
+		Duration = Policy->Duration;
+		break;
+	case EGameplayLayerTransitionMode::Budgeted:
+		Duration = FMath::Min(AuthoredDuration, Policy->Duration);
+		break;
+	}
+	
+	Duration *= FMath::Max(CVarLayerTransitionScale.GetValueOnGameThread(), 0.0f);
+	Stack->SetTransitionDuration(Duration);
+}
+
+void UGameplayPrimaryLayout::PrewarmLayerWidget(TSubclassOf<UCommonActivatableWidget> WidgetClass)
+{
+	if (WidgetClass && !WidgetClass->HasAnyClassFlags(CLASS_Abstract))
+	{
+		if (UCommonActivatableWidget* Widget = CreateWidget<UCommonActivatableWidget>(this, WidgetClass))
 		{
-			const FName SuspendToken = SuspendInputTokens.Pop();
-			UGameplayCommonUILibrary::ResumeInputForPlayer(GetOwningLocalPlayer(), SuspendToken);
+			Widget->TakeWidget();
+			PrewarmedLayerWidgets.Add(Widget);
 		}
 	}
 }
 
+UCommonActivatableWidget* UGameplayPrimaryLayout::TakePrewarmedLayerWidget(const UClass* WidgetClass)
+{
+	const int32 WidgetIndex = PrewarmedLayerWidgets.IndexOfByPredicate([WidgetClass](const UCommonActivatableWidget* Widget)
+	{
+		return Widget && Widget->GetClass() == WidgetClass;
+	});
+	
+	if (WidgetIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+	
+	UCommonActivatableWidget* Widget = PrewarmedLayerWidgets[WidgetIndex];
+	PrewarmedLayerWidgets.RemoveAtSwap(WidgetIndex);
+	
+	// The widget may have been created before the layout was bound to its player.
+	Widget->SetPlayerContext(GetPlayerContext());
+	return Widget;
+}
+
+UCommonActivatableWidget* UGameplayPrimaryLayout::AcquireLayerWidgetInstance(const FGameplayTag& LayerTag, const UCommonActivatableWidgetContainerBase& Layer, UClass* WidgetClass)
+{
+	const FGameplayLayerRetentionPolicy* RetentionPolicy = LayerRetentionPolicies.Find(LayerTag);
+	if (!RetentionPolicy || !RetentionPolicy->bRetainPoppedWidgets)
+	{
+		return TakePrewarmedLayerWidget(WidgetClass);
+	}
+	
+	if (FGameplayRetainedLayerWidgets* Retained = RetainedLayerWidgets.Find(LayerTag))
+	{
+		// Most recently popped first; a widget still in the layer is covered, mid transition or pushed again, not popped.
+		// The entry stays so its Slate tree is still alive when the layer takes it back.
+		for (int32 Index = Retained->Widgets.Num() - 1; Index >= 0; --Index)
+		{
+			UCommonActivatableWidget* Widget = Retained->Widgets[Index];
+			if (Widget && Widget->GetClass() == WidgetClass && !Layer.GetWidgetList().Contains(Widget))
+			{
+				return Widget;
+			}
+		}
+	}
+	
+	if (UCommonActivatableWidget* PrewarmedWidget = TakePrewarmedLayerWidget(WidgetClass))
+	{
+		return PrewarmedWidget;
+	}
+	
+	// Widgets the container creates belong to its pool, which hands them out again on its own, so own the instance instead.
+	return CreateWidget<UCommonActivatableWidget>(GetOwningPlayer(), WidgetClass);
+}
+
+void UGameplayPrimaryLayout::HandleRetainedWidgetDeactivated(TWeakObjectPtr<UCommonActivatableWidget> WeakWidget, FGameplayTag LayerTag)
+{
+	UCommonActivatableWidget* Widget = WeakWidget.Get();
+	const FGameplayLayerRetentionPolicy* RetentionPolicy = LayerRetentionPolicies.Find(LayerTag);
+	if (!Widget || !RetentionPolicy || !RetentionPolicy->bRetainPoppedWidgets)
+	{
+		return;
+	}
+	
+	FGameplayRetainedLayerWidgets& Retained = RetainedLayerWidgets.FindOrAdd(LayerTag);
+	const int32 ExistingIndex = Retained.Widgets.Find(Widget);
+	if (ExistingIndex != INDEX_NONE)
+	{
+		Retained.Widgets.RemoveAt(ExistingIndex);
+		Retained.SlateWidgets.RemoveAt(ExistingIndex);
+	}
+	
+	// The layer is still displaying the widget, so this returns its current Slate tree rather than building a new one.
+	Retained.Widgets.Add(Widget);
+	Retained.SlateWidgets.Add(Widget->TakeWidget());
+	
+	const UCommonActivatableWidgetContainerBase* Layer = RegisteredLayers.FindRef(LayerTag);
+	for (int32 Index = 0; Index < Retained.Widgets.Num() && Retained.Widgets.Num() > RetentionPolicy->MaxRetainedWidgets; )
+	{
+		// Covered widgets also deactivate, only evict those that have actually left the layer.
+		const UCommonActivatableWidget* Candidate = Retained.Widgets[Index];
+		if (!Candidate || !Layer || !Layer->GetWidgetList().Contains(Candidate))
+		{
+			Retained.Widgets.RemoveAt(Index);
+			Retained.SlateWidgets.RemoveAt(Index);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+}
+
+void UGameplayPrimaryLayout::ReleaseRetainedLayerWidgets(FGameplayTag LayerTag)
+{
+	RetainedLayerWidgets.Remove(LayerTag);
+}
+
 UCommonActivatableWidgetContainerBase* UGameplayPrimaryLayout::GetWidgetStackLayer(const FGameplayTag& LayerTag) const
 {
 	checkf(RegisteredLayers.Contains(LayerTag), TEXT("Can not find the widget stack by the tag %s"), *LayerTag.ToString());
@@ -159,11 +620,13 @@ void UGameplayPrimaryLayout::RegisterLayerStack(FGameplayTag LayerTag, UCommonAc
 	if (!IsDesignTime() && !RegisteredLayers.Contains(LayerTag))
 	{
 		Stack->OnTransitioningChanged.AddUObject(this, &UGameplayPrimaryLayout::OnWidgetStackTransitioning);
-		
-		// #todo: Helpe MI Epic Gaymes!
-		// Stack->SetTransitionDuration(0.0);
+		Stack->OnDisplayedWidgetChanged().AddUObject(this, &UGameplayPrimaryLayout::HandleLayerDisplayedWidgetChanged, LayerTag);
 
 		RegisteredLayers.Add(LayerTag, Stack);
+		LayerTagsByContainer.Add(Stack, LayerTag);
+		
+		AuthoredTransitionDurations.Add(Stack, Stack->GetTransitionDuration());
+		ApplyLayerTransitionPolicy(LayerTag, Stack);
 		UE_LOG(LogGameplayPrimaryLayout, Log, TEXT("Layer Stack Registered under the tag %s"), *LayerTag.ToString());
 	}
 }
@@ -98,5 +98,14 @@ private:
 	
 	/** Handle for the asynchronous resource load */
 	TSharedPtr<FStreamableHandle> StreamingHandle;
+	
+	/** Input suspension held while waiting on the shared load cache */
+	FName SharedLoadSuspendToken;
+	
+	/** Whether the widget class was already requested from the shared load cache */
+	bool bRequestedSharedLoad = false;
+	
+	/** Resumes from the shared load cache once the widget class is resident */
+	void OnSharedWidgetClassLoaded();
 };
 
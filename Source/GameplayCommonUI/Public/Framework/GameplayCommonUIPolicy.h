@@ -3,6 +3,7 @@
 #pragma once
 
 #include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
 #include "Widgets/GameplayPrimaryLayout.h"
 #include "Misc/GameplayCommonTypes.h"
 #include "Subsystems/GameplayCommonUISubsystem.h"
@@ -49,9 +50,20 @@ public:
 	/** Removes a primary layout from a local player's viewport */
 	void RemovePrimaryLayoutFromViewport(ULocalPlayer* LocalPlayer, UGameplayPrimaryLayout* Layout);
 	
-	/** Internal notification for when a player's pawn changes, allowing UI to react (e.g., HUD updates) */
+	/** 
+	 * Internal notification for when a player's pawn changes, allowing UI to react (e.g., HUD updates).
+	 * Depending on PawnChangeMode the player's layout is either rebound to the new pawn or recreated.
+	 */
 	void NotifyPawnChanged(ULocalPlayer* LocalPlayer, APawn* NewPawn);
 
+	/**
+	 * Creates the primary layout for a player ahead of time, e.g. during a loading screen, and builds its Slate tree 
+	 * along with one instance of each PrewarmedLayerWidgetClasses. When the player is added the cached layout is 
+	 * attached to the viewport instead of being constructed. Does nothing until the player has a player controller.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Primary Layout")
+	void PrewarmPrimaryLayout(ULocalPlayer* LocalPlayer);
+
 	/** Gets the active UI policy for the current world context */
 	static const UGameplayCommonUIPolicy* GetUIPolicy(const UObject* WorldContextObject);
 	
@@ -78,6 +90,9 @@ protected:
 	
 	/** Hook for when a primary layout widget is actually being destroyed/released */
 	virtual void OnPrimaryLayoutReleased(ULocalPlayer* LocalPlayer, UGameplayPrimaryLayout* Layout);
+	
+	/** Hook for when an existing primary layout has been rebound to a new pawn */
+	virtual void OnPrimaryLayoutPawnChanged(ULocalPlayer* LocalPlayer, UGameplayPrimaryLayout* Layout, APawn* NewPawn);
 
 	/** Factory method to create a primary layout for a player */
 	void CreatePrimaryLayout(ULocalPlayer* LocalPlayer);
@@ -87,15 +102,40 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Primary Layout")
 	TSubclassOf<UGameplayPrimaryLayout> PrimaryLayoutClass;
 
+	/** Layer widgets instantiated with a prewarmed layout, each is used by the first push of its class */
+	UPROPERTY(EditAnywhere, Category = "Primary Layout")
+	TArray<TSoftClassPtr<UCommonActivatableWidget>> PrewarmedLayerWidgetClasses;
+
+	/** 
+	 * Whether the primary layout of a new local player is prewarmed as soon as the player is created. 
+	 * Only players that already have a player controller are prewarmed, the others get their layout when they are added.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Primary Layout")
+	bool bPrewarmPrimaryLayoutOnPlayerCreated = false;
+
+	/** Whether a pawn change rebinds the existing layout or tears it down and creates a new one */
+	UPROPERTY(EditAnywhere, Category = "Primary Layout")
+	EGameplayLayoutPawnChangeMode PawnChangeMode = EGameplayLayoutPawnChangeMode::Rebind;
+
 	/** Reference to the primary layout instance */
 	UPROPERTY()
 	TObjectPtr<UGameplayPrimaryLayout> PrimaryLayout;
 
-	/** Tracks layouts across different viewports (for split-screen) */
+	/** Layouts created ahead of time by PrewarmPrimaryLayout, waiting for their player to be added */
 	UPROPERTY(Transient)
-	TArray<FGameplayPrimaryLayoutViewport> PrimaryViewportLayouts;
+	TMap<TObjectPtr<ULocalPlayer>, TObjectPtr<UGameplayPrimaryLayout>> PrewarmedLayouts;
+
+	/** Tracks layouts across different viewports (for split-screen), keyed by their owning player */
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<ULocalPlayer>, FGameplayPrimaryLayoutViewport> PrimaryViewportLayouts;
+	
+	/** Keeps the PrewarmedLayerWidgetClasses of a prewarmed layout loaded until its layer widgets have been created */
+	TMap<TObjectKey<ULocalPlayer>, TSharedPtr<FStreamableHandle>> PrewarmLayerWidgetsHandles;
 
 private:
+	/** Internal callback for a local player being created, prewarms its layout if enabled */
+	void NotifyPlayerCreated(ULocalPlayer* LocalPlayer);
+	
 	/** Internal callback for player connection */
 	void NotifyPlayerAdded(ULocalPlayer* LocalPlayer);
 	
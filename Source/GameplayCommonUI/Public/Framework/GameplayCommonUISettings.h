@@ -4,6 +4,7 @@
 
 #include "Engine/DeveloperSettings.h"
 #include "GameplayTagContainer.h"
+#include "Misc/GameplayCommonTypes.h"
 #include "GameplayCommonUISettings.generated.h"
 
 class UGameplayConfirmationDialog;
@@ -34,6 +35,23 @@ public:
 	/** A mapping of tags to activatable widget classes, allowing for decoupled widget loading by tag */
 	UPROPERTY(Config, EditAnywhere, Category="Common", meta=(ForceInlineRow, DisplayName = "Registered Activatable Widgets"))
 	TMap<FGameplayTag, TSoftClassPtr<UCommonActivatableWidget>> RegisteredActivatableWidgets;
+	
+	/** 
+	 * Residency of entries in Registered Activatable Widgets, keyed by the same tag. 
+	 * Tags that are not listed here are loaded on demand.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Common", meta=(ForceInlineRow, DisplayName = "Activatable Widget Residency"))
+	TMap<FGameplayTag, EGameplayWidgetResidency> ActivatableWidgetResidency;
+	
+	/** Returns the soft paths of every registered activatable widget with the given residency */
+	TArray<FSoftObjectPath> GetActivatableWidgetPaths(EGameplayWidgetResidency Residency) const;
+
+	/** 
+	 * Seconds a class loaded through the shared load cache of the async action nodes stays resident after its last request. 
+	 * Bursts of nodes asking for the same class within this window reuse the loaded class instead of loading it again.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Common", meta=(ClampMin="0.0", Units="s", DisplayName = "Shared Load Grace Period"))
+	float SharedLoadGracePeriod = 30.0f;
 
 	/** The default widget class used for standard confirmation dialogs */
 	UPROPERTY(Config, EditAnywhere, Category="Confirmation Dialog", meta=(DisplayName = "Confirmation Dialog Class"))
@@ -0,0 +1,36 @@
+﻿// Copyright Spike Plugins 2026. All Rights Reserved.
+
+#pragma once
+
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+/** @brief Stat group for Gameplay Common UI, shown with "stat GameplayCommonUI" */
+DECLARE_STATS_GROUP(TEXT("GameplayCommonUI"), STATGROUP_GameplayCommonUI, STATCAT_Advanced);
+
+/** @brief Time spent informing extension points about a single added or removed extension */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Notify Points Of Extension"), STAT_GameplayUI_NotifyPointsOfExtension, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Time spent informing a newly registered extension point about the existing extensions */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Notify Point Of Extensions"), STAT_GameplayUI_NotifyPointOfExtensions, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Time spent delivering the notifications coalesced by an extension batch */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flush Extension Batch"), STAT_GameplayUI_FlushExtensionBatch, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Time spent by extension points creating their widgets */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Extension Widget"), STAT_GameplayUI_CreateExtensionWidget, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Number of extension points currently registered across all worlds */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registered Extension Points"), STAT_GameplayUI_NumExtensionPoints, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Number of extensions currently registered across all worlds */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registered Extensions"), STAT_GameplayUI_NumExtensions, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Extension point callbacks invoked this frame */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Extension Notifications"), STAT_GameplayUI_ExtensionNotifications, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief Widgets created by extension points this frame */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Extension Widgets Created"), STAT_GameplayUI_ExtensionWidgetsCreated, STATGROUP_GameplayCommonUI, GAMEPLAYCOMMONUI_API);
+
+/** @brief CSV category for Gameplay Common UI, enable with -csvCategories=GameplayCommonUI */
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GAMEPLAYCOMMONUI_API, GameplayCommonUI);
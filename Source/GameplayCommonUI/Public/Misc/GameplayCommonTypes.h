@@ -75,6 +75,78 @@ enum class EGameplayWidgetLayerAsyncState : uint8
 	AfterPush
 };
 
+/** @brief How the UI policy reacts when the pawn of a local player changes */
+UENUM(BlueprintType)
+enum class EGameplayLayoutPawnChangeMode : uint8
+{
+	/** Keep the primary layout and its layer stacks alive and only notify it of the new pawn */
+	Rebind						UMETA(DisplayName = "Rebind"),
+
+	/** Destroy the primary layout and create a new one for the new pawn */
+	Recreate					UMETA(DisplayName = "Recreate")
+};
+
+/** @brief How a layer of the primary layout animates between its widgets */
+UENUM(BlueprintType)
+enum class EGameplayLayerTransitionMode : uint8
+{
+	/** Keep the transition configured on the layer container itself */
+	Default						UMETA(DisplayName = "Default"),
+
+	/** Switch widgets immediately without any transition */
+	Instant						UMETA(DisplayName = "Instant"),
+
+	/** Always animate for the duration given by the policy */
+	Animated					UMETA(DisplayName = "Animated"),
+
+	/** Keep the container's own transition, but never let it run longer than the duration given by the policy */
+	Budgeted					UMETA(DisplayName = "Budgeted")
+};
+
+/** @brief Transition settings applied to a single layer of the primary layout */
+USTRUCT(BlueprintType)
+struct FGameplayLayerTransitionPolicy
+{
+	GENERATED_BODY()
+
+	/** How the layer transitions between widgets */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Transition")
+	EGameplayLayerTransitionMode Mode = EGameplayLayerTransitionMode::Default;
+
+	/** Transition length in seconds for Animated, or the upper bound for Budgeted */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Transition", meta=(ClampMin="0.0", Units="s", EditCondition="Mode == EGameplayLayerTransitionMode::Animated || Mode == EGameplayLayerTransitionMode::Budgeted"))
+	float Duration = 0.2f;
+};
+
+/** @brief Whether a layer of the primary layout keeps popped widgets around for the next push of the same class */
+USTRUCT(BlueprintType)
+struct FGameplayLayerRetentionPolicy
+{
+	GENERATED_BODY()
+
+	/** Keep popped widgets deactivated, with their Slate tree intact, and reuse them on the next push of their class */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Retention")
+	bool bRetainPoppedWidgets = false;
+
+	/** Most widgets kept by the layer, the least recently popped one is released first */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Retention", meta=(ClampMin="1", EditCondition="bRetainPoppedWidgets"))
+	int32 MaxRetainedWidgets = 4;
+};
+
+/** @brief When a registered activatable widget class is loaded and how long it stays in memory */
+UENUM(BlueprintType)
+enum class EGameplayWidgetResidency : uint8
+{
+	/** Loaded when first pushed and released once nothing references it */
+	OnDemand					UMETA(DisplayName = "On Demand"),
+
+	/** Loaded when the first local player logs in and kept loaded from then on */
+	PreloadAtLogin				UMETA(DisplayName = "Preload At Login"),
+
+	/** Loaded as soon as the UI subsystem starts and kept loaded for its whole lifetime */
+	AlwaysResident				UMETA(DisplayName = "Always Resident")
+};
+
 /** @brief Represents a single actionable button within a confirmation dialog */
 USTRUCT(BlueprintType)
 struct FGameplayConfirmationDialogAction
@@ -188,3 +260,44 @@ public:
 		return LocalPlayer == OtherLocalPlayer;
 	}
 };
+
+/** @brief Latency breakdown of a single widget push, every stage is measured from the moment the push was requested */
+USTRUCT(BlueprintType)
+struct FGameplayWidgetPushTiming
+{
+	GENERATED_BODY()
+
+	/** Layer the widget was pushed to */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	FGameplayTag LayerTag;
+
+	/** Name of the pushed widget class */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	FName WidgetClassName;
+
+	/** Whether the widget class had to be streamed in first */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	bool bAsync = false;
+
+	/** Milliseconds until the widget class was loaded */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	float LoadedMs = -1.0f;
+
+	/** Milliseconds until the widget was constructed and added to its layer */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	float ConstructedMs = -1.0f;
+
+	/** Milliseconds until the first frame was rendered with the widget on its layer */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	float FirstPaintMs = -1.0f;
+
+	/** Milliseconds until the widget was activated, stays negative if it never was */
+	UPROPERTY(BlueprintReadOnly, Category="Timing")
+	float ActivatedMs = -1.0f;
+
+	/** Platform time the push was requested at */
+	double RequestTime = 0.0;
+
+	/** Returns the milliseconds elapsed since the push was requested */
+	float GetElapsedMs() const { return static_cast<float>((FPlatformTime::Seconds() - RequestTime) * 1000.0); }
+};
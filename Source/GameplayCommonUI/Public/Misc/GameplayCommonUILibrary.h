@@ -5,10 +5,12 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Engine/StreamableManager.h"
 #include "GameplayCommonUILibrary.generated.h"
 
 class UGameplayPrimaryLayout;
 enum class ECommonInputType : uint8;
+enum class EGameplayWidgetLayerAsyncState : uint8;
 template <typename T> class TSubclassOf;
 
 class UUserWidget;
@@ -16,6 +18,41 @@ class ULocalPlayer;
 class APlayerController;
 class UCommonActivatableWidget;
 
+/**
+ * @brief Handle to a batch of widget classes being prefetched in a single streamable request
+ * 
+ * The classes stay loaded for as long as the handle is held and not released. Copies share the same request.
+ */
+USTRUCT(BlueprintType)
+struct GAMEPLAYCOMMONUI_API FGameplayWidgetPrefetchHandle
+{
+	GENERATED_BODY()
+
+	/** Returns true if the handle refers to a request that was not canceled or released */
+	bool IsValid() const;
+	
+	/** Returns true once every class of the batch has finished loading */
+	bool HasLoadCompleted() const;
+	
+	/** Returns the load progress of the batch, from 0 to 1 */
+	float GetProgress() const;
+	
+	/** 
+	 * Blocks until the batch has loaded, or the timeout elapses if it is greater than zero. 
+	 * Meant for loading screens and transitions, never call it while the player is in control. 
+	 */
+	bool WaitUntilComplete(float Timeout = 0.0f) const;
+	
+	/** Cancels the request, the completion callback is not called */
+	void Cancel();
+	
+	/** Releases the loaded classes so they can be garbage collected once nothing else references them */
+	void Release();
+	
+	/** The combined streamable request */
+	TSharedPtr<FStreamableHandle> StreamableHandle;
+};
+
 /**
  * @brief General purpose utility library for Gameplay UI operations
  * 
@@ -67,7 +104,7 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Library")
 	static FName SuspendInputForPlayer(APlayerController* PlayerController, FName SuspendReason);
 	
-	/** Native helper to suspend input via LocalPlayer */
+	/** Native helper to suspend input via LocalPlayer, tracked per player by the local player subsystem */
 	static FName SuspendInputForPlayer(const ULocalPlayer* LocalPlayer, FName SuspendReason);
 
 	/**
@@ -95,14 +132,65 @@ public:
 	/** Native: Pushes a widget identified by a tag to a layer synchronously */
 	static UCommonActivatableWidget* PushActivatableWidgetForTag(const APlayerController* OwningPlayer, FGameplayTag LayerTag, FGameplayTag WidgetTag);
 	
-	/** Native: Pushes a widget class asynchronously (streaming) */
-	static void PushStreamedActivatableWidgetForClass(const APlayerController* OwningPlayer, FGameplayTag LayerTag, TSoftClassPtr<UCommonActivatableWidget> WidgetClass);
+	/**
+	 * @brief Native: Pushes a widget class asynchronously (streaming)
+	 * 
+	 * While the UI policy is still loading the class starts streaming right away and the push is queued until the 
+	 * player's layout exists. Cancelling the returned handle before then drops the queued push, once the push has run 
+	 * the handle is released and cancelling it does nothing. A push still queued when the UI subsystem is torn down 
+	 * receives Canceled.
+	 * 
+	 * @param StateFunc Optional callback triggered at each stage of the push, receives Canceled if the push can't happen
+	 * @return The streaming handle, or null if nothing was requested
+	 */
+	static TSharedPtr<FStreamableHandle> PushStreamedActivatableWidgetForClass(const APlayerController* OwningPlayer, FGameplayTag LayerTag, TSoftClassPtr<UCommonActivatableWidget> WidgetClass,
+		TFunction<void(EGameplayWidgetLayerAsyncState, UCommonActivatableWidget*)> StateFunc = nullptr);
 	
-	/** Native: Pushes a widget identified by a tag asynchronously (streaming) */
-	static void PushStreamedActivatableWidgetForTag(const APlayerController* OwningPlayer, FGameplayTag LayerTag, FGameplayTag WidgetTag);
-
-private:
-	/** Global counter for input suspensions across all players (used to generate tokens) */
-	static int32 InputSuspensions;
+	/**
+	 * @brief Native: Pushes a widget identified by a tag asynchronously (streaming)
+	 * 
+	 * The class registered for the tag is never loaded on the calling thread, it is streamed in 
+	 * through the asset manager and pushed once available.
+	 * 
+	 * @param StateFunc Optional callback triggered at each stage of the push, receives Canceled if the push can't happen
+	 * @return The streaming handle, or null if nothing was requested
+	 */
+	static TSharedPtr<FStreamableHandle> PushStreamedActivatableWidgetForTag(const APlayerController* OwningPlayer, FGameplayTag LayerTag, FGameplayTag WidgetTag,
+		TFunction<void(EGameplayWidgetLayerAsyncState, UCommonActivatableWidget*)> StateFunc = nullptr);
+	
+	/** Returns the primary layout for a local player through the route its local player subsystem holds, skipping the game instance */
+	static UGameplayPrimaryLayout* ResolvePrimaryLayout(const ULocalPlayer* LocalPlayer);
+	
+	/**
+	 * @brief Prefetches every activatable widget registered under the given tags in a single streamable request
+	 * 
+	 * Registered tags match parent tags too, so prefetching "UI.Screen.PostMatch" loads every post-match screen.
+	 * Keep the returned handle to keep the classes loaded, release it once the context is over.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Library|Prefetch")
+	static FGameplayWidgetPrefetchHandle PrefetchWidgetClassesForTags(const FGameplayTagContainer& WidgetTags);
+	
+	/** Prefetches the given widget classes in a single streamable request, see PrefetchWidgetClassesForTags */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Library|Prefetch")
+	static FGameplayWidgetPrefetchHandle PrefetchWidgetClasses(const TArray<TSoftClassPtr<UUserWidget>>& WidgetClasses);
+	
+	/** Native: Prefetches the given class paths, OnComplete is called once the whole batch is loaded */
+	static FGameplayWidgetPrefetchHandle PrefetchWidgetClassPaths(TArray<FSoftObjectPath> ClassPaths, FStreamableDelegate OnComplete = FStreamableDelegate());
+	
+	/** Returns true once every class of the prefetch has finished loading */
+	UFUNCTION(BlueprintPure, BlueprintCosmetic, Category = "Gameplay UI Library|Prefetch")
+	static bool IsWidgetPrefetchComplete(const FGameplayWidgetPrefetchHandle& PrefetchHandle);
+	
+	/** Returns the load progress of the prefetch, from 0 to 1 */
+	UFUNCTION(BlueprintPure, BlueprintCosmetic, Category = "Gameplay UI Library|Prefetch")
+	static float GetWidgetPrefetchProgress(const FGameplayWidgetPrefetchHandle& PrefetchHandle);
+	
+	/** Cancels a prefetch that is still in flight */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Library|Prefetch")
+	static void CancelWidgetPrefetch(UPARAM(ref) FGameplayWidgetPrefetchHandle& PrefetchHandle);
+	
+	/** Releases the classes kept loaded by a prefetch */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Library|Prefetch")
+	static void ReleaseWidgetPrefetch(UPARAM(ref) FGameplayWidgetPrefetchHandle& PrefetchHandle);
 };
 
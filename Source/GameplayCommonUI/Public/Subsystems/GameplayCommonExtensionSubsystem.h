@@ -4,9 +4,13 @@
 
 #include "GameplayTagContainer.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "GameplayCommonExtensionSubsystem.generated.h"
 
+class AHUD;
+class UCanvas;
 class UGameplayCommonExtensionSubsystem;
+struct FDebugDisplayInfo;
 struct FGameplayUIExtensionRequest;
 
 /** @brief Match rule for extension points */
@@ -23,19 +27,146 @@ enum class EGameplayUIExtensionAction : uint8
 /** @brief Native delegate for extension point updates */
 DECLARE_DELEGATE_TwoParams(FGameplayExtendUIExtensionPointSignature, EGameplayUIExtensionAction ExtensionAction, const FGameplayUIExtensionRequest& ExtensionRequest);
 
+/** @brief Slot of an extension or extension point in the subsystem storage, the generation detects reused slots */
+struct FGameplayUIExtensionSlotId
+{
+public:
+	/** Index of the slot in its store */
+	int32 Index = INDEX_NONE;
+	
+	/** Generation of the slot when this id was issued, bumped every time the slot is freed */
+	uint32 Generation = 0;
+	
+	/** Checks if the id was ever issued, not whether it still resolves */
+	FORCEINLINE bool IsSet() const { return Index != INDEX_NONE; }
+	
+	bool operator==(const FGameplayUIExtensionSlotId& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FGameplayUIExtensionSlotId& Other) const { return !operator==(Other); }
+	friend FORCEINLINE uint32 GetTypeHash(const FGameplayUIExtensionSlotId& SlotId) { return HashCombineFast(::GetTypeHash(SlotId.Index), ::GetTypeHash(SlotId.Generation)); }
+};
+
+/**
+ * @brief Chunked store with a free list used by the extension subsystem
+ * 
+ * Entries live in fixed size chunks so their addresses stay stable while callbacks register more entries, 
+ * freed slots are recycled and their generation bumped so stale ids stop resolving.
+ */
+template<typename EntryType, int32 ChunkSize = 64>
+class TGameplayUIExtensionSlab
+{
+public:
+	/** Constructs a default entry in a free slot and returns its id */
+	FGameplayUIExtensionSlotId Add()
+	{
+		int32 Index = INDEX_NONE;
+		if (!FreeIndices.IsEmpty())
+		{
+			Index = FreeIndices.Pop(EAllowShrinking::No);
+		}
+		else
+		{
+			Index = NumSlots++;
+			if (Index / ChunkSize >= Chunks.Num())
+			{
+				Chunks.Add(MakeUnique<FSlot[]>(ChunkSize));
+			}
+		}
+
+		FSlot& Slot = GetSlot(Index);
+		Slot.Entry.Emplace();
+		++NumEntries;
+
+		return FGameplayUIExtensionSlotId{Index, Slot.Generation};
+	}
+
+	/** Destroys the entry and recycles its slot, ids issued for it stop resolving */
+	void Remove(const FGameplayUIExtensionSlotId& SlotId)
+	{
+		if (Find(SlotId))
+		{
+			FSlot& Slot = GetSlot(SlotId.Index);
+			Slot.Entry.Reset();
+			++Slot.Generation;
+			--NumEntries;
+
+			FreeIndices.Push(SlotId.Index);
+		}
+	}
+
+	/** Returns the entry for the id, or null if its slot was freed since */
+	EntryType* Find(const FGameplayUIExtensionSlotId& SlotId)
+	{
+		if (SlotId.Index >= 0 && SlotId.Index < NumSlots)
+		{
+			FSlot& Slot = GetSlot(SlotId.Index);
+			if (Slot.Generation == SlotId.Generation && Slot.Entry.IsSet())
+			{
+				return &Slot.Entry.GetValue();
+			}
+		}
+
+		return nullptr;
+	}
+
+	const EntryType* Find(const FGameplayUIExtensionSlotId& SlotId) const
+	{
+		return const_cast<TGameplayUIExtensionSlab*>(this)->Find(SlotId);
+	}
+
+	/** Calls the function on every live entry */
+	template<typename FunctionType>
+	void ForEach(FunctionType&& Function)
+	{
+		for (int32 Index = 0; Index < NumSlots; ++Index)
+		{
+			FSlot& Slot = GetSlot(Index);
+			if (Slot.Entry.IsSet())
+			{
+				Function(Slot.Entry.GetValue());
+			}
+		}
+	}
+
+	/** Number of live entries */
+	int32 Num() const { return NumEntries; }
+
+	/** Destroys every entry and releases the chunks */
+	void Empty()
+	{
+		Chunks.Empty();
+		FreeIndices.Empty();
+		NumSlots = 0;
+		NumEntries = 0;
+	}
+
+private:
+	struct FSlot
+	{
+		TOptional<EntryType> Entry;
+		uint32 Generation = 0;
+	};
+
+	FSlot& GetSlot(int32 Index) { return Chunks[Index / ChunkSize][Index % ChunkSize]; }
+
+	TArray<TUniquePtr<FSlot[]>> Chunks;
+	TArray<int32> FreeIndices;
+	int32 NumSlots = 0;
+	int32 NumEntries = 0;
+};
+
 /** 
  * @brief Internal data structure representing a UI extension 
  * 
  * An extension consists of a target point (tag), a priority, optional context, 
  * and the actual data (like a widget class).
  */
-struct FGameplayUIExtension : TSharedFromThis<FGameplayUIExtension>
+struct FGameplayUIExtension
 {
 public:
 	/** The extension point this extension is intended for. */
 	FGameplayTag ExtensionPointTag;
 	
-	/** Priority that determines ordering if multiple extensions target the same point */
+	/** Priority that determines ordering if multiple extensions target the same point, higher values are delivered first */
 	int32 Priority = INDEX_NONE;
 	
 	/** Optional object used to filter or provide context for the extension */
@@ -43,6 +174,9 @@ public:
 	
 	/** The data payload for this extension (e.g., UWidget subclass or data asset) */
 	TObjectPtr<UObject> Data = nullptr;
+	
+	/** Position in the subsystem's list for ExtensionPointTag, INDEX_NONE once unregistered */
+	int32 ListIndex = INDEX_NONE;
 };
 
 /** @brief A handle identifying a registered UI extension, used for unregistration */
@@ -53,27 +187,27 @@ struct FGameplayUIExtensionHandle
 
 	FGameplayUIExtensionHandle() 
 	{}
-	FGameplayUIExtensionHandle(UGameplayCommonExtensionSubsystem* InExtensionSource, const TSharedPtr<FGameplayUIExtension>& InDataPtr) 
+	FGameplayUIExtensionHandle(UGameplayCommonExtensionSubsystem* InExtensionSource, const FGameplayUIExtensionSlotId& InSlotId) 
 		: ExtensionSource(InExtensionSource)
-		, DataPtr(InDataPtr) 
+		, SlotId(InSlotId) 
 	{}
 
 	/** Unregisters the associated extension from the subsystem */
 	void Unregister();
 
-	/** Checks if the handle points to a valid extension */
-	FORCEINLINE bool IsValid() const { return DataPtr.IsValid(); }
+	/** Checks if the handle was issued for an extension */
+	FORCEINLINE bool IsValid() const { return SlotId.IsSet(); }
 	
-	bool operator==(const FGameplayUIExtensionHandle& Other) const { return DataPtr == Other.DataPtr; }
+	bool operator==(const FGameplayUIExtensionHandle& Other) const { return SlotId == Other.SlotId && ExtensionSource == Other.ExtensionSource; }
 	bool operator!=(const FGameplayUIExtensionHandle& Other) const { return !operator==(Other); }
-	friend FORCEINLINE uint32 GetTypeHash(FGameplayUIExtensionHandle Handle) { return PointerHash(Handle.DataPtr.Get()); }
+	friend FORCEINLINE uint32 GetTypeHash(const FGameplayUIExtensionHandle& Handle) { return GetTypeHash(Handle.SlotId); }
 
 private:
 	/** The subsystem that created this extension */
 	TWeakObjectPtr<UGameplayCommonExtensionSubsystem> ExtensionSource;
 	
-	/** Shared pointer to the internal extension data */
-	TSharedPtr<FGameplayUIExtension> DataPtr;
+	/** Generation-counted slot of the extension in the subsystem storage */
+	FGameplayUIExtensionSlotId SlotId;
 	
 	friend UGameplayCommonExtensionSubsystem;
 };
@@ -130,8 +264,30 @@ enum class EGameplayUIExtensionPointMatch : uint8
 	PartialMatch
 };
 
+/** @brief Position of an extension point inside one list of the subsystem's extension point index */
+struct FGameplayUIExtensionIndexPosition
+{
+public:
+	/** Extension tag of the index list */
+	FGameplayTag IndexTag;
+	
+	/** Position of the point in that list */
+	int32 ListIndex = INDEX_NONE;
+};
+
+/** @brief Entry of an index list, pointing back at the position record the point keeps for it */
+struct FGameplayUIExtensionIndexEntry
+{
+public:
+	/** The indexed extension point */
+	FGameplayUIExtensionSlotId ExtensionPointId;
+	
+	/** Index of the matching record in the point's IndexPositions */
+	int32 PositionIndex = INDEX_NONE;
+};
+
 /** @brief Internal representation of a registered extension point (a place where UI can be extended) */
-struct FGameplayUIExtensionPoint : TSharedFromThis<FGameplayUIExtensionPoint>
+struct FGameplayUIExtensionPoint
 {
 public:
 	/** The tag uniquely identifying this extension point */
@@ -148,9 +304,28 @@ public:
 	
 	/** Native callback to invoke when an extension is added or removed */
 	FGameplayExtendUIExtensionPointSignature Callback;
+	
+	/** Size of the pending batch queue when this point was registered, INDEX_NONE if it was registered outside a batch */
+	int32 BatchSequence = INDEX_NONE;
+	
+	/** Batch round BatchSequence refers to, 0 if the point was registered outside a batch */
+	uint32 BatchRound = 0;
+	
+	/** Position in the subsystem's list for ExtensionPointTag, INDEX_NONE once unregistered */
+	int32 ListIndex = INDEX_NONE;
+	
+	/** Every index list holding this point, so unregistration removes it by position */
+	TArray<FGameplayUIExtensionIndexPosition> IndexPositions;
+
+	/** Memoized result of the data class check, AllowedDataClasses never changes once the point is registered */
+	mutable TMap<TObjectKey<UClass>, bool> DataClassContractCache;
 
 	/** Checks if a specific extension meets the requirements of this point */
 	bool DoesExtensionPassContract(const FGameplayUIExtension* Extension) const;
+	
+private:
+	/** Checks the data class against AllowedDataClasses, caching the result per class */
+	bool DoesDataClassPassContract(const UClass* DataClass) const;
 };
 
 /** @brief A handle identifying a registered extension point */
@@ -162,27 +337,27 @@ struct FGameplayUIExtensionPointHandle
 public:
 	FGameplayUIExtensionPointHandle() 
 	{}
-	FGameplayUIExtensionPointHandle(UGameplayCommonExtensionSubsystem* InExtensionSource, const TSharedPtr<FGameplayUIExtensionPoint>& InDataPtr) 
+	FGameplayUIExtensionPointHandle(UGameplayCommonExtensionSubsystem* InExtensionSource, const FGameplayUIExtensionSlotId& InSlotId) 
 		: ExtensionSource(InExtensionSource)
-		, DataPtr(InDataPtr) 
+		, SlotId(InSlotId) 
 	{}
 
 	/** Unregisters the associated extension point from the subsystem */
 	void Unregister();
 
-	/** Checks if the handle points to a valid extension point */
-	FORCEINLINE bool IsValid() const { return DataPtr.IsValid(); }
+	/** Checks if the handle was issued for an extension point */
+	FORCEINLINE bool IsValid() const { return SlotId.IsSet(); }
 	
-	bool operator==(const FGameplayUIExtensionPointHandle& Other) const { return DataPtr == Other.DataPtr; }
+	bool operator==(const FGameplayUIExtensionPointHandle& Other) const { return SlotId == Other.SlotId && ExtensionSource == Other.ExtensionSource; }
 	bool operator!=(const FGameplayUIExtensionPointHandle& Other) const { return !operator==(Other); }
-	friend uint32 GetTypeHash(const FGameplayUIExtensionPointHandle& Handle) { return PointerHash(Handle.DataPtr.Get()); }
+	friend uint32 GetTypeHash(const FGameplayUIExtensionPointHandle& Handle) { return GetTypeHash(Handle.SlotId); }
 
 private:
 	/** The subsystem that created this extension point */
 	TWeakObjectPtr<UGameplayCommonExtensionSubsystem> ExtensionSource;
 	
-	/** Shared pointer to the internal extension point data */
-	TSharedPtr<FGameplayUIExtensionPoint> DataPtr;
+	/** Generation-counted slot of the extension point in the subsystem storage */
+	FGameplayUIExtensionSlotId SlotId;
 	
 	friend UGameplayCommonExtensionSubsystem;
 };
@@ -246,15 +421,33 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Extension")
 	void UnregisterExtensionPoint(const FGameplayUIExtensionPointHandle& ExtensionPointHandle);
 	
+	/**
+	 * Opens an extension batch. Until the matching EndExtensionBatch, registering or unregistering extensions only 
+	 * updates the subsystem state; the notifications are coalesced and delivered to each extension point when the 
+	 * outermost batch closes. An extension added and removed inside the same batch is never delivered.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Extension")
+	void BeginExtensionBatch();
+	
+	/** Closes an extension batch and flushes the coalesced notifications once the outermost batch ends */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Extension")
+	void EndExtensionBatch();
+	
+	/** Returns true while at least one extension batch is open */
+	bool IsInExtensionBatch() const { return ExtensionBatchDepth > 0; }
+	
 protected:
 	/** Helper to convert internal extension data into a request structure for callbacks */
-	FGameplayUIExtensionRequest CreateExtensionRequest(const TSharedPtr<FGameplayUIExtension>& Extension);
+	FGameplayUIExtensionRequest CreateExtensionRequest(const FGameplayUIExtensionSlotId& ExtensionId, const FGameplayUIExtension& Extension);
 	
 	/** Informs an extension point about all currently registered extensions that match its criteria */
-	void NotifyExtensionPointOfExtensions(const TSharedPtr<FGameplayUIExtensionPoint>& ExtensionPoint);
+	void NotifyExtensionPointOfExtensions(const FGameplayUIExtensionSlotId& ExtensionPointId);
 	
 	/** Informs all registered extension points about a new or removed extension */
-	void NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction ExtensionAction, const TSharedPtr<FGameplayUIExtension>& Extension);
+	void NotifyExtensionPointsOfExtension(EGameplayUIExtensionAction ExtensionAction, const FGameplayUIExtensionSlotId& ExtensionId);
+	
+	/** Draws the registered points, extensions and notification counts per tag under "ShowDebug GameplayCommonUI" */
+	virtual void OnShowDebugInfo(AHUD* HUD, UCanvas* Canvas, const FDebugDisplayInfo& DisplayInfo, float& YL, float& YPos);
 	
 	/** Blueprint: Registers a new extension point */
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Gameplay UI Extension", meta = (DisplayName = "Register Extension Point"))
@@ -284,12 +477,116 @@ protected:
 	FGameplayUIExtensionHandle RegisterExtensionAsDataForContext(FGameplayTag ExtensionPointTag, UObject* ContextObject, UObject* Data, int32 Priority = -1);
 	
 private:
-	typedef TArray<TSharedPtr<FGameplayUIExtensionPoint>> FExtensionPointList;
+	/** Storage of every registered extension point, addressed by the slot ids held in the lists and handles */
+	TGameplayUIExtensionSlab<FGameplayUIExtensionPoint> ExtensionPoints;
+	
+	/** Storage of every registered extension, addressed by the slot ids held in the lists and handles */
+	TGameplayUIExtensionSlab<FGameplayUIExtension> Extensions;
+	
+	typedef TArray<FGameplayUIExtensionSlotId> FExtensionPointList;
 	/** Map of tags to a list of registered points at that tag */
 	TMap<FGameplayTag, FExtensionPointList> ExtensionPointMap;
 
-	typedef TArray<TSharedPtr<FGameplayUIExtension>> FExtensionList;
+	typedef TArray<FGameplayUIExtensionSlotId> FExtensionList;
 	/** Map of tags to a list of registered extensions at that tag */
 	TMap<FGameplayTag, FExtensionList> ExtensionMap;
+
+	typedef TArray<FGameplayUIExtensionIndexEntry> FExtensionPointIndexList;
+	/** 
+	 * Ancestor index of extension tags to every point that can receive them: the points registered at the 
+	 * tag itself plus the partial match points registered on any of its parents. Entries are built on first use 
+	 * and only exist while at least one point matches the tag.
+	 */
+	TMap<FGameplayTag, FExtensionPointIndexList> ExtensionPointIndex;
+
+	/** Returns all points matching extensions registered at the given tag, building the index entry if needed */
+	const FExtensionPointIndexList& GetExtensionPointsForTag(const FGameplayTag& ExtensionTag);
+	
+	/** Appends the point to an index list, recording its position on the point */
+	static void AddToIndexList(FExtensionPointIndexList& IndexList, const FGameplayTag& IndexTag, const FGameplayUIExtensionSlotId& ExtensionPointId, FGameplayUIExtensionPoint& ExtensionPoint);
+
+	/** Adds a newly registered point to the cached index entries of its tag and, for partial matches, of its descendants */
+	void AddExtensionPointToIndex(const FGameplayUIExtensionSlotId& ExtensionPointId, FGameplayUIExtensionPoint& ExtensionPoint);
+
+	/** Removes an unregistered point from the index lists that hold it by their stored positions, dropping the lists left empty */
+	void RemoveExtensionPointFromIndex(const FGameplayUIExtensionSlotId& ExtensionPointId, FGameplayUIExtensionPoint& ExtensionPoint);
+	
+	/** An extension notification deferred while a batch is open */
+	struct FPendingExtensionNotification
+	{
+		EGameplayUIExtensionAction ExtensionAction = EGameplayUIExtensionAction::Added;
+		FGameplayUIExtensionSlotId ExtensionId;
+		
+		/** Points registered earlier in the batch than this sequence don't receive the notification */
+		int32 MinPointSequence = INDEX_NONE;
+	};
+	
+	/** Number of currently open extension batches */
+	int32 ExtensionBatchDepth = 0;
+	
+	/** True while the notifications of the outermost batch are being delivered */
+	bool bFlushingExtensionBatch = false;
+	
+	/** 
+	 * Round of the notifications currently being queued. Each flush delivers one round at a time, 
+	 * batches closed from inside a flush callback queue the next round, delivered once the current one returns.
+	 */
+	uint32 PendingBatchRound = 1;
+	
+	/** Notifications queued by the open batch, in registration order */
+	TArray<FPendingExtensionNotification> PendingNotifications;
+	
+	/** Queue index of every extension still waiting for its Added notification */
+	TMap<FGameplayUIExtensionSlotId, int32> PendingAddedIndices;
+	
+	/** Extensions unregistered inside the batch, kept in storage until their Removed notification is delivered */
+	TArray<FGameplayUIExtensionSlotId> PendingFreeExtensions;
+	
+	/** Delivers every queued notification round by round, grouped per extension tag so each point list is resolved once */
+	void FlushPendingNotifications();
+	
+	/** Returns true if the extension is still registered in the extension map */
+	bool IsExtensionRegistered(const FGameplayUIExtensionSlotId& ExtensionId) const;
+	
+	/** Returns the point if its slot is live and it has not been unregistered */
+	const FGameplayUIExtensionPoint* FindRegisteredExtensionPoint(const FGameplayUIExtensionSlotId& ExtensionPointId) const;
+	
+	/** Number of extension point callbacks currently executing */
+	int32 ExtensionPointCallbackDepth = 0;
+	
+	/** Points unregistered from inside a callback, freed once no callback is executing */
+	TArray<FGameplayUIExtensionSlotId> PendingFreeExtensionPoints;
+	
+#if !UE_BUILD_SHIPPING
+	/** Callbacks invoked per extension tag since the subsystem was created, to attribute construction spikes */
+	TMap<FGameplayTag, int32> NotificationCountsByTag;
+#endif
+	
+	/** Invokes the point callback, deferring the release of points unregistered while it runs */
+	void ExecuteExtensionPointCallback(const FGameplayUIExtensionPoint& ExtensionPoint, EGameplayUIExtensionAction ExtensionAction, const FGameplayUIExtensionRequest& Request);
+};
+
+/** @brief Keeps an extension batch open on the given subsystem for the lifetime of the scope */
+struct FGameplayUIExtensionBatchScope : FNoncopyable
+{
+	explicit FGameplayUIExtensionBatchScope(UGameplayCommonExtensionSubsystem* InExtensionSubsystem)
+		: ExtensionSubsystem(InExtensionSubsystem)
+	{
+		if (ExtensionSubsystem.IsValid())
+		{
+			ExtensionSubsystem->BeginExtensionBatch();
+		}
+	}
+	
+	~FGameplayUIExtensionBatchScope()
+	{
+		if (UGameplayCommonExtensionSubsystem* ExtensionSubsystemPtr = ExtensionSubsystem.Get())
+		{
+			ExtensionSubsystemPtr->EndExtensionBatch();
+		}
+	}
+	
+private:
+	TWeakObjectPtr<UGameplayCommonExtensionSubsystem> ExtensionSubsystem;
 };
 
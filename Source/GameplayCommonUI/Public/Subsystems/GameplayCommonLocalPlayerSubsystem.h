@@ -8,8 +8,10 @@
 #include "GameplayCommonLocalPlayerSubsystem.generated.h"
 
 class UGameplayCommonUIPolicy;
+class UGameplayPrimaryLayout;
 class UGameplayConfirmationDescriptor;
 class APlayerState;
+class UGameplayConfirmationDialog;
 
 /** @brief Native delegate for the result of a confirmation dialog */
 DECLARE_DELEGATE_OneParam(FGameplayConfirmationDialogResultSignature, EGameplayConfirmationResult /* Result */)
@@ -57,25 +59,127 @@ public:
 	 */
 	virtual void ShowError(UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback = FGameplayConfirmationDialogResultSignature());
 	
+	/**
+	 * @brief Displays a standard confirmation dialog without blocking on its class
+	 * 
+	 * The dialog is pushed right away if its class is resident, otherwise it is streamed in first. 
+	 * The callback receives Unknown if the dialog could not be shown.
+	 */
+	virtual void ShowConfirmationAsync(UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback = FGameplayConfirmationDialogResultSignature());
+	
+	/**
+	 * @brief Displays an error dialog without blocking on its class
+	 * 
+	 * Meant for disconnects and travel failures, where a synchronous load would freeze the game. 
+	 * The callback receives Unknown if the dialog could not be shown.
+	 */
+	virtual void ShowErrorAsync(UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback = FGameplayConfirmationDialogResultSignature());
+	
+	/**
+	 * @brief Suspends all input for this player until the returned token is resumed
+	 * 
+	 * Suspensions are reference counted, the input filters are only written when the 
+	 * first suspension starts and when the last one is resumed.
+	 * 
+	 * @param SuspendReason A name identifying who is suspending input
+	 * @return A unique token to pass to ResumeInput
+	 */
+	FName SuspendInput(FName SuspendReason);
+	
+	/** Releases a suspension previously returned by SuspendInput, unknown tokens are ignored */
+	void ResumeInput(FName SuspendToken);
+	
+	/** Returns true while at least one suspension is held for this player */
+	bool IsInputSuspended() const { return !InputSuspensionTokens.IsEmpty(); }
+	
+	/** Returns the tokens currently holding this player's input suspended, in the order they were taken */
+	const TArray<FName>& GetInputSuspensionTokens() const { return InputSuspensionTokens; }
+	
 	/** Native event for when the pawn changes */
 	FGameplayLocalPlayerPawnSetSignature OnLocalPlayerPawnSet;
 	
 	/** Native event for when the player state becomes valid/changes */
 	FGameplayLocalPlayerStateSetSignature OnLocalPlayerStateSet;
 	
+	/** 
+	 * Notifies the subsystem that the controller's player state may have been assigned. 
+	 * Call from APlayerController::OnRep_PlayerState to get the notification without any delay.
+	 */
+	void NotifyPlayerStateChanged();
+	
+	/** Returns the seconds it took for the player state to become ready after the last controller change, negative while still waiting */
+	double GetPlayerStateTimeToReady() const { return PlayerStateTimeToReady; }
+	
+	/** Returns the primary layout the UI policy created for this player, without going through the game instance */
+	UGameplayPrimaryLayout* GetPrimaryLayout() const { return PrimaryLayout.Get(); }
+	
+	/** Sets the route returned by GetPrimaryLayout, called by the UI policy when it creates or releases this player's layout */
+	void SetPrimaryLayout(UGameplayPrimaryLayout* InPrimaryLayout) { PrimaryLayout = InPrimaryLayout; }
+	
 protected:
 	/** Internal handler for pawn change notifications */
 	virtual void HandlePawnChanged(APawn* NewPawn);	
 	
 private:
-	/** Polls or checks for player state validity if it's not immediately available */
-	void CheckPlayerStateValidity();
+	/** Broadcasts OnLocalPlayerStateSet and stops waiting if the controller's player state is available */
+	bool TryNotifyPlayerStateReady();
+	
+	/** Starts listening for the player state of the current controller to arrive */
+	void WaitForPlayerState(UWorld* World);
+	
+	/** Stops every player state listener and the fallback timer */
+	void StopWaitingForPlayerState();
+	
+	/** Checks again once a player state actor has been spawned, its controller is assigned on replication in the same or a later frame */
+	void HandleActorSpawned(AActor* SpawnedActor);
+	
+	/** Checks on the next tick, re-arming itself every tick until the controller's player state is set */
+	void CheckPlayerStateNextTick();
+	
+	/** Check once the wait timed out, logs and falls back to HandlePlayerStateSlowCheck if the player state still isn't there */
+	void HandlePlayerStateTimeout();
+	
+	/** Low frequency check used after the timeout, until the player state arrives or the controller goes away */
+	void HandlePlayerStateSlowCheck();
+	
+	/** Pushes a dialog of an already loaded class to the modal layer, returns false if there is no layout to push to */
+	bool PushConfirmationDialog(TSubclassOf<UGameplayConfirmationDialog> DialogClass, UGameplayConfirmationDescriptor* Descriptor, const FGameplayConfirmationDialogResultSignature& ResultCallback) const;
+	
+	/** Pushes a dialog once its class is available, streaming it in if needed */
+	void ShowConfirmationDialogAsync(const TSoftClassPtr<UGameplayConfirmationDialog>& DialogClass, UGameplayConfirmationDescriptor* Descriptor, FGameplayConfirmationDialogResultSignature ResultCallback);
+	
+	/** Writes the input type filters for this player, only called when the suspended state flips */
+	void ApplyInputSuspension(bool bSuspended) const;
 	
 private:
-	/** Handle for the player state validity polling timer */
-	FTimerHandle TimerHandle_CheckPlayerState;
+	/** Handle for the timeout used if no event reports the player state, then for the low frequency check that follows it */
+	FTimerHandle TimerHandle_PlayerStateTimeout;
+	
+	/** Handle for the per-tick check armed once a player state has been spawned */
+	FTimerHandle TimerHandle_PlayerStateNextTick;
+	
+	/** Handle for the world's actor spawned listener while waiting for the player state */
+	FDelegateHandle ActorSpawnedHandle;
+	
+	/** World the player state listeners were registered with */
+	TWeakObjectPtr<UWorld> PlayerStateWaitWorld;
+	
+	/** Platform time the current controller was assigned at */
+	double PlayerStateWaitStartTime = 0.0;
+	
+	/** Seconds between the controller change and the player state becoming ready */
+	double PlayerStateTimeToReady = -1.0;
 	
 	/** Cached reference to the player controller */
 	TWeakObjectPtr<APlayerController> WeakPlayerController;
+	
+	/** Layout of this player, weakly held so a stale route can never keep a layout alive */
+	TWeakObjectPtr<UGameplayPrimaryLayout> PrimaryLayout;
+	
+	/** Tokens of every active input suspension for this player */
+	TArray<FName> InputSuspensionTokens;
+	
+	/** Counter used to make suspension tokens unique for this player */
+	int32 InputSuspensionSerial = 0;
 };
 
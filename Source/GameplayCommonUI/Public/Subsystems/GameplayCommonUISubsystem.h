@@ -5,12 +5,20 @@
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "GameFramework/HUD.h" // For AHUD definition
 #include "Engine/Canvas.h" // For UCanvas definition
+#include "Misc/GameplayCommonTypes.h"
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
 #include "GameplayCommonUISubsystem.generated.h"
 
 class UGameplayButtonBase;
 class UGameplayCommonUIPolicy;
 class UGameplayPrimaryLayout;
 class ULocalPlayer;
+struct FStreamableHandle;
+enum class EGameplayWidgetResidency : uint8;
+
+/** @brief Broadcast once the UI policy has been loaded and created */
+DECLARE_MULTICAST_DELEGATE_OneParam(FGameplayUIPolicyReadySignature, UGameplayCommonUIPolicy*);
 
 /** @brief Broadcast when the global primary layout is set or changed */
 DECLARE_MULTICAST_DELEGATE_OneParam(FGameplayPrimaryLayoutSetSignature, UGameplayPrimaryLayout*);
@@ -34,6 +42,9 @@ public:
 	/** Native event fired when the primary layout is established */
 	FGameplayPrimaryLayoutSetSignature OnPrimaryLayoutSet;
 	
+	/** Native event fired once the UI policy class has been streamed in and the policy created */
+	FGameplayUIPolicyReadySignature OnUIPolicyReady;
+	
 	/** Blueprint-assignable event for when button descriptions change globally */
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FGameplayButtonDescriptionChangedSignature OnButtonDescriptionChanged;
@@ -50,6 +61,9 @@ public:
 	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
 	//~End of USubsystem interface
 
+	/** Notification for when a local player is created, before it has a player controller */
+	virtual void NotifyPlayerCreated(ULocalPlayer* LocalPlayer);
+	
 	/** Notification for when a new local player is added to the game session */
 	virtual void NotifyPlayerAdded(ULocalPlayer* LocalPlayer);
 	
@@ -62,14 +76,53 @@ public:
 	/** Forces a broadcast of the button description change event */
 	virtual void NotifyButtonDescriptionTextChanged(UGameplayButtonBase* Button, const FText& NewDescriptionText);
 	
+	/**
+	 * @brief Streams a class in through the shared load cache
+	 * 
+	 * Identical requests made while a load is in flight share one streamable handle, and loaded classes stay resident 
+	 * for the configured grace period after their last request. The callback runs right away if the class is cached, 
+	 * and also runs if the load fails, so check the class before using it.
+	 */
+	void RequestSharedClassLoad(const FSoftObjectPath& ClassPath, FStreamableDelegate OnLoaded);
+	
+	/** Appends a finished widget push to the history of its layer, dropping the oldest entry once the history is full */
+	void RecordWidgetPushTiming(const FGameplayWidgetPushTiming& PushTiming);
+	
+	/** Returns the most recent widget push timings of a layer, oldest first */
+	UFUNCTION(BlueprintCallable, Category="Profiling")
+	TArray<FGameplayWidgetPushTiming> GetWidgetPushHistory(FGameplayTag LayerTag) const;
+	
+	/**
+	 * Builds the primary layout of a player that has a player controller ahead of time, see UGameplayCommonUIPolicy::PrewarmPrimaryLayout. 
+	 * Requests made while the UI policy is still loading run once it is ready.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category="Policy")
+	void PrewarmPrimaryLayout(ULocalPlayer* LocalPlayer);
+	
 	/** Returns the currently active UI policy */
 	UFUNCTION(BlueprintPure, Category="Policy")
 	UGameplayCommonUIPolicy* GetUIPolicy() const { return CurrentPolicy; }
+	
+	/** Returns true while the UI policy class is still being streamed in */
+	bool IsLoadingUIPolicy() const { return UIPolicyLoadHandle.IsValid(); }
+	
+	/** 
+	 * Runs the request once the UI policy is ready, right away if it already is. 
+	 * Queued requests run after the players added in the meantime have received their layouts. 
+	 * OnCanceled runs instead if the subsystem is torn down while the request is still queued.
+	 */
+	void CallOrQueueUntilPolicyReady(TFunction<void()>&& Request, TFunction<void()>&& OnCanceled = nullptr);
 
 protected:
 	/** Internal method to swap the current UI policy (used during initialization) */
 	void SwitchToPolicy(UGameplayCommonUIPolicy* NewPolicy);
 	
+	/** Creates the policy from the streamed class, then replays everything that was queued while it loaded */
+	void HandleUIPolicyClassLoaded();
+	
+	/** Starts streaming every registered widget class with the given residency and keeps it loaded through the returned handle */
+	TSharedPtr<FStreamableHandle> LoadResidentWidgetClasses(EGameplayWidgetResidency Residency) const;
+	
 	/** Hook for rendering debug information to the screen via HUD */
 	virtual void OnShowDebugInfo(AHUD* HUD, UCanvas* Canvas, const FDebugDisplayInfo& DisplayInfo, float& YL, float& YPos);
 	
@@ -77,5 +130,64 @@ private:
 	/** The instance of the active UI policy */
 	UPROPERTY(Transient)
 	TObjectPtr<UGameplayCommonUIPolicy> CurrentPolicy;
+	
+	/** A class load shared by every request for the same path */
+	struct FSharedClassLoad
+	{
+		/** Handle keeping the class loaded, owned by this cache */
+		TSharedPtr<FStreamableHandle> Handle;
+		
+		/** Callbacks waiting for the load to finish */
+		TArray<FStreamableDelegate> PendingCallbacks;
+		
+		/** Platform time of the last request, the grace period counts from here */
+		double LastRequestTime = 0.0;
+		
+		/** Whether the load has finished */
+		bool bLoaded = false;
+	};
+	
+	/** Runs the callbacks of a finished shared load */
+	void HandleSharedClassLoaded(FSoftObjectPath ClassPath);
+	
+	/** Releases shared loads whose grace period has run out, unregisters itself once the cache is empty */
+	bool SweepSharedClassLoads(float DeltaTime);
+	
+	/** Shared class loads, keyed by class path */
+	TMap<FSoftObjectPath, FSharedClassLoad> SharedClassLoads;
+	
+	/** Ticker handle for the shared load sweep */
+	FTSTicker::FDelegateHandle SweepSharedClassLoadsHandle;
+	
+	/** Streams the UI policy class in during startup */
+	TSharedPtr<FStreamableHandle> UIPolicyLoadHandle;
+	
+	/** Players added before the policy was ready */
+	TArray<TWeakObjectPtr<ULocalPlayer>> PendingPlayersAdded;
+	
+	/** A request made before the policy was ready */
+	struct FPendingPolicyRequest
+	{
+		/** Runs once the policy is ready */
+		TFunction<void()> Request;
+		
+		/** Runs if the request is dropped before the policy is ready */
+		TFunction<void()> OnCanceled;
+	};
+	
+	/** Requests made before the policy was ready */
+	TArray<FPendingPolicyRequest> PendingPolicyRequests;
+	
+	/** Recent widget push timings, per layer tag */
+	TMap<FGameplayTag, TArray<FGameplayWidgetPushTiming>> WidgetPushHistory;
+	
+	/** Keeps the Always Resident widget classes loaded for the lifetime of the subsystem */
+	TSharedPtr<FStreamableHandle> AlwaysResidentWidgetsHandle;
+	
+	/** Keeps the Preload At Login widget classes loaded once the first player has been added */
+	TSharedPtr<FStreamableHandle> LoginPreloadWidgetsHandle;
+	
+	/** Keeps the confirmation and error dialog classes loaded once the first player has been added */
+	TSharedPtr<FStreamableHandle> DialogClassesHandle;
 };
 
@@ -61,6 +61,25 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI Extension", meta=(IsBindableEvent="True"))
 	FOnConfigureWidgetForData ConfigureWidgetForData;
 
+	/**
+	 * Entry widgets to create ahead of time and park in the entry pool, keyed by class with the number of instances.
+	 * Removed entries always return to that pool and are reused by class, so prewarming only matters for the first
+	 * extensions received after this point is constructed.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI Extension|Pooling", meta = (ClampMin = "0"))
+	TMap<TSubclassOf<UUserWidget>, int32> PrewarmedEntryClasses;
+
+	/**
+	 * If true, widgets for added extensions are not created inside the registration callback but queued and built
+	 * over the following frames, within WidgetCreationBudgetMs per frame. Higher priority extensions are built first.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI Extension|Deferred Creation")
+	bool bDeferWidgetCreation = false;
+
+	/** Time budget in milliseconds spent creating queued extension widgets per frame, at least one is always created */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI Extension|Deferred Creation", meta = (EditCondition = "bDeferWidgetCreation", ClampMin = "0.0", Units = "ms"))
+	float WidgetCreationBudgetMs = 1.0f;
+
 	/** Handles to the registered points in the extension subsystem */
 	TArray<FGameplayUIExtensionPointHandle> ExtensionPointHandles;
 
@@ -69,6 +88,23 @@ protected:
 	TMap<FGameplayUIExtensionHandle, TObjectPtr<UUserWidget>> ExtensionMapping;
 	
 private:
+	/** Whether the prewarmed entries have already been created, the pool outlives RebuildWidget */
+	bool bEntryPoolPrewarmed = false;
+	
+	/** Added extensions waiting for their widget to be created, by descending priority then arrival order */
+	UPROPERTY(Transient)
+	TArray<FGameplayUIExtensionRequest> PendingExtensionRequests;
+	
+	/** Requests before this index were already dequeued by the running tick, they are compacted once it ends */
+	int32 PendingExtensionsHead = 0;
+
+	/** Ticker handle processing PendingExtensionRequests while it is not empty */
+	FTSTicker::FDelegateHandle ProcessPendingExtensionsHandle;
+	
+private:
+	/** Creates the prewarmed entries and immediately releases them into the entry pool */
+	void PrewarmEntryPool();
+	
 	/** Clears all current extensions and unregisters from the subsystem */
 	void ResetExtensionPoint();
 	
@@ -80,5 +116,14 @@ private:
 	
 	/** Callback from the subsystem when an extension matching our criteria is added or removed */
 	void OnAddOrRemoveExtension(EGameplayUIExtensionAction Action, const FGameplayUIExtensionRequest& Request);
+	
+	/** Resolves the widget class for an added extension and creates its entry */
+	void CreateExtensionWidget(const FGameplayUIExtensionRequest& Request);
+	
+	/** Creates queued extension widgets until the frame budget is spent, returns whether work remains */
+	bool ProcessPendingExtensions(float DeltaTime);
+	
+	/** Drops every queued request and stops the processing ticker */
+	void ClearPendingExtensions();
 };
 
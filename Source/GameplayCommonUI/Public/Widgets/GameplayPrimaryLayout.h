@@ -12,8 +12,27 @@
 #include "Engine/AssetManager.h"
 #include "GameplayPrimaryLayout.generated.h"
 
+class SWidget;
+class SWindow;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogGameplayPrimaryLayout, Log, All);
 
+/** @brief Popped widgets a layer keeps for reuse, least recently popped first */
+USTRUCT()
+struct FGameplayRetainedLayerWidgets
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UCommonActivatableWidget>> Widgets;
+	
+	/** Slate tree of each retained widget, index for index. A widget only references its Slate tree weakly, so this keeps it built */
+	TArray<TSharedPtr<SWidget>> SlateWidgets;
+};
+
+/** @brief Broadcast when a layer starts or finishes a transition, with the seconds it took once finished */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FGameplayLayerTransitionSignature, FGameplayTag /*LayerTag*/, bool /*bIsTransitioning*/, double /*TransitionSeconds*/);
+
 /**
  * @brief The root UI layout for a single player
  *
@@ -31,6 +50,7 @@ public:
 
 	//~Begin UUserWidget interface
 	virtual void NativeOnInitialized() override;
+	virtual void NativeDestruct() override;
 	//~End of UUserWidget interface
 		
 	/** Returns the primary layout for the first local player */
@@ -53,6 +73,28 @@ public:
 	
 	/** Checks if the layout is currently dormant */
 	bool IsDormant() const { return bIsDormant; }
+	
+	/** Re-targets pawn-dependent content at the new pawn, the layout and its layer stacks stay alive */
+	void NotifyPawnChanged(APawn* NewPawn);
+	
+	/** Returns the pawn this layout was last bound to */
+	APawn* GetBoundPawn() const { return BoundPawn.Get(); }
+	
+	/** Native event fired when any layer starts or finishes a transition */
+	FGameplayLayerTransitionSignature OnLayerTransitionChanged;
+	
+	/** Replaces the transition policy of a layer and applies it right away if the layer is registered */
+	void SetLayerTransitionPolicy(FGameplayTag LayerTag, const FGameplayLayerTransitionPolicy& Policy);
+	
+	/** Reapplies the transition policy of every registered layer, e.g. after the global transition scale changed */
+	void RefreshLayerTransitions();
+	
+	/** Returns true while the given layer is transitioning between widgets */
+	bool IsLayerTransitioning(FGameplayTag LayerTag) const;
+	
+	/** Releases every popped widget retained by the given layer */
+	UFUNCTION(BlueprintCallable, Category = "Stack")
+	void ReleaseRetainedLayerWidgets(FGameplayTag LayerTag);
 
 	/** 
 	 * @brief Asynchronously loads and pushes a widget to a specific layer
@@ -80,24 +122,51 @@ public:
 	{
 		static_assert(TIsDerivedFrom<ActivatableWidgetT, UCommonActivatableWidget>::IsDerived, "Only CommonActivatableWidgets can be used here");
 
+		if (ActivatableWidgetClass.IsNull())
+		{
+			StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+			return nullptr;
+		}
+
+		const double RequestTime = FPlatformTime::Seconds();
+
 		static FName NAME_PushingWidgetToLayer("PushingWidgetToLayer");
 		const FName SuspendInputToken = bSuspendInputUntilComplete ? UGameplayCommonUILibrary::SuspendInputForPlayer(GetOwningPlayer(), NAME_PushingWidgetToLayer) : NAME_None;
 
 		FStreamableManager& StreamableManager = UAssetManager::Get().GetStreamableManager();
 		TSharedPtr<FStreamableHandle> StreamingHandle = StreamableManager.RequestAsyncLoad(ActivatableWidgetClass.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this,
-		[this, LayerTag, ActivatableWidgetClass, StateFunc, SuspendInputToken]()
+		[this, LayerTag, ActivatableWidgetClass, StateFunc, SuspendInputToken, RequestTime]()
 		{
 			UGameplayCommonUILibrary::ResumeInputForPlayer(GetOwningPlayer(), SuspendInputToken);
 
+			PendingPushTiming.Emplace();
+			PendingPushTiming->RequestTime = RequestTime;
+			PendingPushTiming->LoadedMs = PendingPushTiming->GetElapsedMs();
+			PendingPushTiming->bAsync = true;
+
 			ActivatableWidgetT* Widget = PushWidgetToLayerStack<ActivatableWidgetT>(LayerTag, ActivatableWidgetClass.Get(), [StateFunc](ActivatableWidgetT& WidgetToInit)
 			{
 				StateFunc(EGameplayWidgetLayerAsyncState::Initialize, &WidgetToInit);
 			});
 
+			if (!Widget)
+			{
+				StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+				return;
+			}
+
 			StateFunc(EGameplayWidgetLayerAsyncState::AfterPush, Widget);
 			Widget->SetFocus();
 		}));
 
+		if (!StreamingHandle.IsValid())
+		{
+			// The request was rejected outright, so neither delegate will ever fire.
+			UGameplayCommonUILibrary::ResumeInputForPlayer(GetOwningPlayer(), SuspendInputToken);
+			StateFunc(EGameplayWidgetLayerAsyncState::Canceled, nullptr);
+			return nullptr;
+		}
+
 		// Set up a cancel delegate so that we can resume input if this handler is canceled.
 		StreamingHandle->BindCancelDelegate(FStreamableDelegate::CreateWeakLambda(this, [this, StateFunc, SuspendInputToken]()
 		{
@@ -121,17 +190,38 @@ public:
 	{
 		static_assert(TIsDerivedFrom<ActivatableWidgetT, UCommonActivatableWidget>::IsDerived, "Only CommonActivatableWidgets can be used here");
 
+		FGameplayWidgetPushTiming PushTiming = BeginWidgetPushTiming(LayerTag, ActivatableWidgetClass);
+
 		if (UCommonActivatableWidgetContainerBase* Layer = GetLayerStackContainer(LayerTag))
 		{
 			UE_LOG(LogGameplayPrimaryLayout, Display, TEXT("Pushing Widget [%s] to Layer [%s]"), *GetNameSafe(ActivatableWidgetClass), *LayerTag.ToString());
 			
-			return Layer->AddWidget<ActivatableWidgetT>(ActivatableWidgetClass, InitInstanceFunc);
+			ActivatableWidgetT* Widget = Cast<ActivatableWidgetT>(AcquireLayerWidgetInstance(LayerTag, *Layer, ActivatableWidgetClass));
+			if (Widget)
+			{
+				InitInstanceFunc(*Widget);
+				Layer->AddWidgetInstance(*Widget);
+			}
+			else
+			{
+				Widget = Layer->AddWidget<ActivatableWidgetT>(ActivatableWidgetClass, InitInstanceFunc);
+			}
+			
+			RecordWidgetLayer(Widget, LayerTag);
+			TrackWidgetPushTiming(Widget, MoveTemp(PushTiming));
+			return Widget;
 		}
 		
 		UE_LOG(LogGameplayPrimaryLayout, Warning, TEXT("Failed to push widget [%s]: Layer [%s] not found!"), *GetNameSafe(ActivatableWidgetClass), *LayerTag.ToString());
 		return nullptr;
 	}
 
+	/** 
+	 * Creates an instance of the widget class and builds its Slate tree ahead of time. 
+	 * The next push of exactly that class to any layer attaches this instance instead of constructing one.
+	 */
+	void PrewarmLayerWidget(TSubclassOf<UCommonActivatableWidget> WidgetClass);
+
 	/** Returns the container widget for a given layer tag */
 	UFUNCTION(BlueprintPure, Category="Stack")
 	UCommonActivatableWidgetContainerBase* GetWidgetStackLayer(const FGameplayTag& LayerTag) const;
@@ -164,18 +254,117 @@ protected:
 	/** Called when the dormancy state changes */
 	virtual void OnIsDormantChanged();
 	
+	/** Called when the owning player's pawn changes while this layout is kept alive */
+	virtual void NativeOnPawnChanged(APawn* NewPawn);
+	
+	/** Blueprint hook to re-target pawn-dependent content when the owning player's pawn changes */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Primary Layout", meta = (DisplayName = "On Pawn Changed"))
+	void BP_OnPawnChanged(APawn* NewPawn);
+	
 	/** Called when a layer container begins or ends a transition */
 	virtual void OnWidgetStackTransitioning(UCommonActivatableWidgetContainerBase* Widget, bool bIsTransitioning);
 	
+	/** Per-layer retention of popped widgets, layers without an entry construct a new widget on every push */
+	UPROPERTY(EditAnywhere, Category = "Primary Layout", meta = (ForceInlineRow, Categories = "GameplayCommonUI.Layer"))
+	TMap<FGameplayTag, FGameplayLayerRetentionPolicy> LayerRetentionPolicies;
+	
+	/** Per-layer transition policies, layers without an entry keep the transition set on their container */
+	UPROPERTY(EditAnywhere, Category = "Primary Layout", meta = (ForceInlineRow, Categories = "GameplayCommonUI.Layer"))
+	TMap<FGameplayTag, FGameplayLayerTransitionPolicy> LayerTransitionPolicies;
+	
 private:
 	/** Internal dormancy flag */
 	bool bIsDormant = false;
+	
+	/** The pawn the layout content currently targets */
+	TWeakObjectPtr<APawn> BoundPawn;
+	
+	/** Layer widgets created ahead of time, waiting for their first push */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UCommonActivatableWidget>> PrewarmedLayerWidgets;
 
-	/** History of input tokens used to suspend input during async operations */
-	TArray<FName> SuspendInputTokens;
+	/** A transition that is currently running on one of the layers */
+	struct FActiveLayerTransition
+	{
+		/** Input suspension held for the length of the transition */
+		FName SuspendInputToken;
+		
+		/** Platform time the transition started at */
+		double StartTime = 0.0;
+	};
+	
+	/** Transitions currently running, keyed by their layer container */
+	TMap<TObjectKey<UCommonActivatableWidgetContainerBase>, FActiveLayerTransition> ActiveLayerTransitions;
+	
+	/** Transition duration each container was authored with, before any policy was applied */
+	TMap<TObjectKey<UCommonActivatableWidgetContainerBase>, float> AuthoredTransitionDurations;
+	
+	/** Applies the policy of a single layer to its container */
+	void ApplyLayerTransitionPolicy(const FGameplayTag& LayerTag, UCommonActivatableWidgetContainerBase* Stack);
+	
+	/** Timing handed from an async push to the synchronous push it ends in */
+	TOptional<FGameplayWidgetPushTiming> PendingPushTiming;
+	
+	/** Pushes still waiting for their first paint or activation, keyed by the pushed widget */
+	TMap<TObjectKey<UCommonActivatableWidget>, FGameplayWidgetPushTiming> InFlightPushTimings;
+	
+	/** Handle of the window rendered callback, bound only while pushes are in flight */
+	FDelegateHandle WindowRenderedHandle;
+	
+	/** Starts timing a push, continuing the pending async timing if there is one */
+	FGameplayWidgetPushTiming BeginWidgetPushTiming(const FGameplayTag& LayerTag, const UClass* WidgetClass);
+	
+	/** Marks a pushed widget as constructed and waits for its first paint and activation */
+	void TrackWidgetPushTiming(UCommonActivatableWidget* Widget, FGameplayWidgetPushTiming&& PushTiming);
+	
+	/** Records the first paint of every in-flight push once a window has rendered */
+	void HandleWindowRendered(SWindow& Window, void* ViewportRHIPtr);
+	
+	/** Hands a finished push timing to the UI subsystem and stops tracking it */
+	void FinishWidgetPushTiming(const UCommonActivatableWidget* Widget);
+	
+	/** Remembers which layer a pushed widget lives in, so removing it doesn't need to search every layer, and watches it for leaving */
+	void RecordWidgetLayer(UCommonActivatableWidget* Widget, const FGameplayTag& LayerTag);
+	
+	/** Drops a widget from both layer indices and stops watching it */
+	void ForgetWidgetLayer(const TObjectKey<UCommonActivatableWidget>& WidgetKey);
+	
+	/** Forgets a deactivated widget that has left its layer, or marks it to be checked once its layer has released its popped widgets */
+	void HandleLayerWidgetDeactivated(TWeakObjectPtr<UCommonActivatableWidget> WeakWidget);
+	
+	/** Forgets the deactivated widgets of the layer that are no longer in it, called once the layer has released its popped widgets */
+	void HandleLayerDisplayedWidgetChanged(UCommonActivatableWidget* DisplayedWidget, FGameplayTag LayerTag);
+	
+	/** Removes and returns a prewarmed widget of exactly the given class, if any */
+	UCommonActivatableWidget* TakePrewarmedLayerWidget(const UClass* WidgetClass);
+	
+	/** 
+	 * Returns an existing or new instance to push with AddWidgetInstance: a retained widget of the layer, then a prewarmed one, 
+	 * then a fresh one if the layer retains widgets. Returns null when the container should create the widget from its own pool.
+	 */
+	UCommonActivatableWidget* AcquireLayerWidgetInstance(const FGameplayTag& LayerTag, const UCommonActivatableWidgetContainerBase& Layer, UClass* WidgetClass);
+	
+	/** Moves a deactivated widget and its Slate tree to the most recently used end of its layer's retained widgets, evicting the oldest past the cap */
+	void HandleRetainedWidgetDeactivated(TWeakObjectPtr<UCommonActivatableWidget> WeakWidget, FGameplayTag LayerTag);
+	
+	/** Popped widgets kept per layer by the retention policies */
+	UPROPERTY(Transient)
+	TMap<FGameplayTag, FGameplayRetainedLayerWidgets> RetainedLayerWidgets;
 	
 	/** Persistent map of layer tags to container widgets */
 	UPROPERTY(Transient, meta=(GameplayTagFilter="GameplayCommonUI.Layer"))
 	TMap<FGameplayTag, UCommonActivatableWidgetContainerBase*> RegisteredLayers;
+	
+	/** Reverse of RegisteredLayers, from container to its layer tag */
+	TMap<TObjectKey<UCommonActivatableWidgetContainerBase>, FGameplayTag> LayerTagsByContainer;
+	
+	/** Layer of every widget pushed through this layout, entries are dropped once the widget leaves its layer */
+	TMap<TObjectKey<UCommonActivatableWidget>, FGameplayTag> WidgetLayers;
+	
+	/** Reverse of WidgetLayers, the widgets pushed through this layout per layer */
+	TMap<FGameplayTag, TSet<TObjectKey<UCommonActivatableWidget>>> LayerWidgets;
+	
+	/** Widgets of each layer that deactivated since its displayed widget last changed, they are either covered or leaving */
+	TMap<FGameplayTag, TSet<TObjectKey<UCommonActivatableWidget>>> DeactivatedLayerWidgets;
 };
 